@@ -5,22 +5,42 @@
 // All rights reserved.
 
 #include "format.h"
+#include "Int128.hpp"
+#include "IsExactSize.hpp"
+#include "IsMultithreaded.hpp"
+#include "IsSupported.hpp"
+#include "Separator.hpp"
 #include <boost/spirit/include/karma.hpp>
 #include "alexandrescu.hpp"
 #include "reverse.hpp"
 #include "tmpbuf.hpp"
 #include "counting.hpp"
+#include "simd.hpp"
+#include "twopass.hpp"
+#include "parallel.hpp"
+#include "reciprocal.hpp"
+#include "padded.hpp"
+#include "fixed.hpp"
+#include "radix.hpp"
+#include "swar.hpp"
+#include "incremental.hpp"
+#include "bucketed.hpp"
 
 class AlgoFmtFormat {
  public:
   static const bool enabled = true;
 
-  template <class Vector>
-  static void run(char* buffer, const Vector& in) {
+  static const char* name() {
+    return "fmt::FormatInt";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
     for(auto& i: in) {
       fmt::FormatDec(buffer, i);
+      Separator::write(buffer);
     }
-    *buffer = '\0';
+    return separator::terminate<Separator>(buffer, in);
   }
 };
 
@@ -28,26 +48,82 @@ class AlgoBoostKarma {
  public:
   static const bool enabled = true;
 
-  template <class Vector>
-  static void run(char* buffer, const Vector& in) {
+  static const char* name() {
+    return "boost::spirit::karma";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
     for(auto& i: in) {
       using namespace boost::spirit;
       karma::generate(buffer, int_, i);
+      Separator::write(buffer);
     }
-    *buffer = '\0';
+    return separator::terminate<Separator>(buffer, in);
   }
 };
 
+#if HAVE_INT128
+// fmt::FormatDec and karma::int_ have no 128-bit overloads/policies
+template <>
+class IsSupported<AlgoFmtFormat, int128_t> {
+ public:
+  static const bool value = false;
+};
+
+template <>
+class IsSupported<AlgoFmtFormat, uint128_t> {
+ public:
+  static const bool value = false;
+};
+
+template <>
+class IsSupported<AlgoBoostKarma, int128_t> {
+ public:
+  static const bool value = false;
+};
+
+template <>
+class IsSupported<AlgoBoostKarma, uint128_t> {
+ public:
+  static const bool value = false;
+};
+#endif
+
 class AlgoAlexandrescu {
  public:
   static const bool enabled = true;
 
-  template <class Vector>
-  static void run(char* buffer, const Vector& in) {
+  static const char* name() {
+    return "alexandrescu";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
     for(auto& i: in) {
       alexandrescu::generate(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoAlexandrescuLzcnt {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "alexandrescu_lzcnt";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    using Integer = typename Vector::value_type;
+    for (auto& i: in) {
+      alexandrescu::generate<Integer, alexandrescu::Lzcnt>(buffer, i);
+      Separator::write(buffer);
     }
-    *buffer = '\0';
+    return separator::terminate<Separator>(buffer, in);
   }
 };
 
@@ -55,12 +131,36 @@ class AlgoCounting {
  public:
   static const bool enabled = true;
 
-  template <class Vector>
-  static void run(char* buffer, const Vector& in) {
+  static const char* name() {
+    return "counting";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
     for (auto& i: in) {
       counting::generate(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoCountingLzcnt {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "counting_lzcnt";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    using Integer = typename Vector::value_type;
+    for (auto& i: in) {
+      counting::generate<Integer, counting::Lzcnt>(buffer, i);
+      Separator::write(buffer);
     }
-    *buffer = '\0';
+    return separator::terminate<Separator>(buffer, in);
   }
 };
 
@@ -68,12 +168,17 @@ class AlgoReverse {
  public:
   static const bool enabled = true;
 
-  template <class Vector>
-  static void run(char* buffer, const Vector& in) {
+  static const char* name() {
+    return "reverse";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
     for (auto& i: in) {
       reverse::generate(buffer, i);
+      Separator::write(buffer);
     }
-    *buffer = '\0';
+    return separator::terminate<Separator>(buffer, in);
   }
 };
 
@@ -81,12 +186,354 @@ class AlgoTmpbuf {
  public:
   static const bool enabled = true;
 
-  template <class Vector>
-  static void run(char* buffer, const Vector& in) {
+  static const char* name() {
+    return "tmpbuf";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
     for (auto& i: in) {
       tmpbuf::generate(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoSimd {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "simd";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    simd::generate<Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoTwoPass {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "twopass";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    // allocated once per thread, reused by next runs (`run` may be called
+    // concurrently by parallel/coalescing/pipeline front-ends)
+    thread_local twopass::Offsets offsets;
+
+    const size_t total = twopass::count<Separator>(in, offsets);
+    twopass::write<Separator>(buffer, in, offsets);
+    buffer[total] = '\0';
+    return buffer + total;
+  }
+
+  // `result` sized exactly by the first pass (see IsExactSize.hpp)
+  template <class Separator = separator::None, class Vector>
+  static char* generate(std::vector<char>& result, const Vector& in) {
+    thread_local twopass::Offsets offsets;
+
+    const size_t total = twopass::generate<Separator>(in, offsets, result);
+    return result.data() + total;
+  }
+};
+
+template <>
+class IsExactSize<AlgoTwoPass> {
+ public:
+  static const bool value = true;
+};
+
+class AlgoParallel {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "parallel";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    static const unsigned threads = parallel::default_threads();
+
+    const size_t total = parallel::generate<Separator>(buffer, in, threads);
+    buffer[total] = '\0';
+    return buffer + total;
+  }
+};
+
+template <>
+class IsMultithreaded<AlgoParallel> {
+ public:
+  static const bool value = true;
+};
+
+class AlgoReciprocal {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "reciprocal";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    for (auto& i: in) {
+      reciprocal::generate(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoPaddedZero {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "padded_zero";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    for (auto& i: in) {
+      padded::generate<'0'>(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoPaddedSpace {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "padded_space";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    for (auto& i: in) {
+      padded::generate<' '>(buffer, i);
+      Separator::write(buffer);
     }
-    *buffer = '\0';
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+// Column of 6 bytes (e.g. "-00042", "012345")
+class AlgoPaddedZero6 {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "padded_zero_6";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    for (auto& i: in) {
+      padded::generate<'0', 6>(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoFixedCents {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "fixed_2";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    for (auto& i: in) {
+      fixed::generate<2>(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoFixedMicro {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "fixed_6";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    for (auto& i: in) {
+      fixed::generate<6>(buffer, i);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+// Scale known at runtime only (e.g. from column metadata)
+class AlgoFixedRuntime {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "fixed_6_runtime";
+  }
+
+  // volatile: no constant propagation
+  static int scale() {
+    static volatile int result = 6;
+    return result;
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    const int scale = AlgoFixedRuntime::scale();
+    for (auto& i: in) {
+      fixed::generate(buffer, i, scale);
+      Separator::write(buffer);
+    }
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+// Not decimal: base-16/base-8 cost compared to base-10 (see radix.hpp)
+class AlgoHex {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "hex";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    radix::generate<radix::Hex<false>, Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoHexUpper {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "hex_upper";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    radix::generate<radix::Hex<true>, Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoHexSimd {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "hex_simd";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    radix::generate_simd<radix::Hex<false>, Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoOctal {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "octal";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    radix::generate<radix::Octal, Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoOctalSimd {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "octal_simd";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    radix::generate_simd<radix::Octal, Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoSwar {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "swar";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    swar::generate<Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoIncremental {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "incremental";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    incremental::generate<Separator>(buffer, in);
+    return separator::terminate<Separator>(buffer, in);
+  }
+};
+
+class AlgoBucketed {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "bucketed";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    using Unsigned =
+        typename std::make_unsigned<typename Vector::value_type>::type;
+
+    // allocated once per thread, reused by next runs
+    thread_local bucketed::Scratch<Unsigned> scratch;
+
+    bucketed::generate<Separator>(buffer, in, scratch);
+    return separator::terminate<Separator>(buffer, in);
   }
 };
 
@@ -0,0 +1,470 @@
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::shuffle
+#include <climits> // INT_MAX
+#include <cmath> // std::ceil
+#include <iomanip> // std::setw
+#include <iostream> // std::cout
+#include <random> // std::mt19937
+#include <string>
+#include <typeinfo> // std::type_info
+#include <vector>
+
+#if defined(__linux__)
+# include <pthread.h> // pthread_setaffinity_np
+# include <sched.h> // sched_getcpu
+#elif defined(_WIN32)
+# include <windows.h> // SetThreadAffinityMask
+#endif
+
+#include "PerfCounters.hpp"
+#include "Results.hpp"
+#include "Statistics.hpp"
+#include "Timer.hpp"
+
+// Benchmark engine:
+//   * iterations per sample calibrated to `TARGET` time
+//   * warm-up runs before the first sample
+//   * samples of different tasks interleaved in random order
+//   * main thread pinned to one CPU
+//   * result of every iteration escapes (optimization barrier)
+//   * robust statistics (see Statistics.hpp), difference with the best
+//     task reported only if significant
+namespace benchmark {
+
+#if !defined(BENCHMARK_TARGET_MS)
+# define BENCHMARK_TARGET_MS 10
+#endif
+
+#if defined(NDEBUG)
+  // samples per task
+  const int SAMPLES = 15;
+  // untimed runs before the first sample
+  const int WARM_UP_RUNS = 2;
+  // minimal time of one sample
+  const Duration TARGET = std::chrono::milliseconds(BENCHMARK_TARGET_MS);
+#else
+  // check results only
+  const int SAMPLES = 1;
+  const int WARM_UP_RUNS = 0;
+  const Duration TARGET = Duration(0);
+#endif
+
+// Compiler must assume that memory pointed by `pointer` is read
+// and modified (i.e. stores to buffer can't be removed)
+inline void escape(const void* pointer) {
+#if defined(_MSC_VER)
+  static const void* volatile sink;
+  sink = pointer;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "g"(pointer) : "memory");
+#endif
+}
+
+// Affinity of main thread: pinned to one CPU, no migrations between
+// samples. Not supported: pin/unpin do nothing.
+class Affinity {
+ public:
+  // Pin to the CPU thread is running on
+  static bool pin() {
+#if defined(__linux__)
+    State& state = get_state();
+    if (!state.saved) {
+      if (pthread_getaffinity_np(
+          pthread_self(), sizeof(state.original), &state.original
+      ) != 0) {
+        return false;
+      }
+      const int cpu = sched_getcpu();
+      if (cpu < 0) {
+        return false;
+      }
+      CPU_ZERO(&state.pinned);
+      CPU_SET(cpu, &state.pinned);
+      state.saved = true;
+    }
+    state.is_pinned = (pthread_setaffinity_np(
+        pthread_self(), sizeof(state.pinned), &state.pinned
+    ) == 0);
+    return state.is_pinned;
+#elif defined(_WIN32)
+    State& state = get_state();
+    if (!state.saved) {
+      const DWORD_PTR mask = DWORD_PTR(1) << GetCurrentProcessorNumber();
+      state.original = SetThreadAffinityMask(GetCurrentThread(), mask);
+      state.pinned = mask;
+      state.saved = (state.original != 0);
+      state.is_pinned = state.saved;
+      return state.is_pinned;
+    }
+    state.is_pinned =
+        (SetThreadAffinityMask(GetCurrentThread(), state.pinned) != 0);
+    return state.is_pinned;
+#else
+    return false;
+#endif
+  }
+
+  // Restore original affinity (e.g. for multithreaded algorithm:
+  // new threads inherit affinity)
+  static void unpin() {
+#if defined(__linux__)
+    State& state = get_state();
+    if (state.is_pinned) {
+      pthread_setaffinity_np(
+          pthread_self(), sizeof(state.original), &state.original
+      );
+      state.is_pinned = false;
+    }
+#elif defined(_WIN32)
+    State& state = get_state();
+    if (state.is_pinned) {
+      SetThreadAffinityMask(GetCurrentThread(), state.original);
+      state.is_pinned = false;
+    }
+#endif
+  }
+
+  static bool pinned() {
+#if defined(__linux__) || defined(_WIN32)
+    return get_state().is_pinned;
+#else
+    return false;
+#endif
+  }
+
+ private:
+#if defined(__linux__) || defined(_WIN32)
+  struct State {
+    bool saved = false;
+    bool is_pinned = false;
+# if defined(__linux__)
+    cpu_set_t original;
+    cpu_set_t pinned;
+# else
+    DWORD_PTR original;
+    DWORD_PTR pinned;
+# endif
+  };
+
+  static State& get_state() {
+    static State state;
+    return state;
+  }
+#endif
+};
+
+// Original affinity while object alive
+class Unpinned {
+ public:
+  Unpinned(): was_pinned_(Affinity::pinned()) {
+    Affinity::unpin();
+  }
+
+  ~Unpinned() {
+    if (was_pinned_) {
+      Affinity::pin();
+    }
+  }
+
+  Unpinned(const Unpinned&) = delete;
+  Unpinned& operator=(const Unpinned&) = delete;
+
+ private:
+  const bool was_pinned_;
+};
+
+// Number of `iteration()` calls in one sample to take at least `target`.
+// Calibration runs also warm up caches and branch predictors.
+template <class Iteration>
+int calibrate_iterations(Iteration iteration, Duration target) {
+  int iterations = 1;
+  while (true) {
+    const Timer::TimePoint start = Timer::now();
+    for (int i = 0; i < iterations; ++i) {
+      iteration();
+    }
+    const Duration elapsed = Timer::now() - start;
+
+    // enough timer resolution: scale to target
+    if (elapsed * 10 >= target || iterations >= INT_MAX / 10) {
+      if (elapsed >= target) {
+        return iterations;
+      }
+      const double scale = target / std::max(elapsed, Duration(1));
+      return static_cast<int>(std::min(
+          std::ceil(iterations * scale), static_cast<double>(INT_MAX)
+      ));
+    }
+    iterations *= 10;
+  }
+}
+
+// Time of one iteration: `iterations` calls of `iteration()` in one
+// sample, at least `TARGET` time. First call: warm-up and calibration.
+// Performance counters (if enabled) collected in timed loops only.
+class Sampler {
+ public:
+  Sampler(): iterations_(0) {
+  }
+
+  template <class Iteration>
+  void sample(Iteration iteration) {
+    if (iterations_ == 0) {
+      for (int i = 0; i < WARM_UP_RUNS; ++i) {
+        iteration();
+      }
+      iterations_ = calibrate_iterations(iteration, TARGET);
+    }
+
+    counters_.start();
+    const Timer::TimePoint start = Timer::now();
+    for (int i = 0; i < iterations_; ++i) {
+      iteration();
+    }
+    const Timer::TimePoint stop = Timer::now();
+    counters_.stop();
+
+    samples_.push_back(Duration(stop - start) / iterations_);
+  }
+
+  const Durations& samples() const {
+    return samples_;
+  }
+
+  int iterations() const {
+    return iterations_;
+  }
+
+  // Totals of all samples
+  const perf::Values& counters() const {
+    return counters_.totals();
+  }
+
+ private:
+  int iterations_;
+  Durations samples_;
+  perf::Counters counters_;
+};
+
+// Benchmarked item (algorithm + input)
+class Task {
+ public:
+  virtual ~Task() = default;
+
+  // Add one sample
+  virtual void run() = 0;
+
+  // Empty if task is disabled
+  virtual Statistics statistics() const = 0;
+
+  virtual const char* name() const = 0;
+
+  // Iterations per sample
+  virtual int iterations() const = 0;
+
+  // Totals of all samples (see PerfCounters.hpp)
+  virtual perf::Values counters() const = 0;
+
+  // Only tasks of the same group are compared with each other
+  // (e.g. formatters with the same expected format)
+  virtual const std::type_info& group() const {
+    return typeid(void);
+  }
+};
+
+// Task measured by `Sampler`: derived class implements `run` and adds
+// one sample per call by `sample(iteration)`
+class SampledTask: public Task {
+ public:
+  explicit SampledTask(const char* name): name_(name) {
+  }
+
+  Statistics statistics() const override {
+    return Statistics(sampler_.samples());
+  }
+
+  const char* name() const override {
+    return name_;
+  }
+
+  int iterations() const override {
+    return sampler_.iterations();
+  }
+
+  perf::Values counters() const override {
+    return sampler_.counters();
+  }
+
+ protected:
+  template <class Iteration>
+  void sample(Iteration iteration) {
+    sampler_.sample(iteration);
+  }
+
+ private:
+  const char* name_;
+  Sampler sampler_;
+};
+
+// `SAMPLES` rounds, every task sampled once per round in random order:
+// drifts (frequency scaling, other processes) affect all tasks equally
+inline void run_interleaved(const std::vector<Task*>& tasks) {
+  std::vector<Task*> order(tasks);
+  std::mt19937 generator(std::random_device{}());
+
+  std::cout << "Run tests";
+  for (int i = 0; i < SAMPLES; ++i) {
+    std::cout << " #" << i << std::flush;
+    std::shuffle(order.begin(), order.end(), generator);
+    for (auto task: order) {
+      task->run();
+    }
+  }
+  std::cout << std::endl;
+}
+
+// Statistics of the task with minimal median among tasks of `group`
+inline Statistics best(
+    const std::vector<Task*>& tasks, const std::type_info& group
+) {
+  Statistics result;
+  for (auto task: tasks) {
+    if (task->group() != group) {
+      continue;
+    }
+    const Statistics statistics = task->statistics();
+    if (statistics.empty()) {
+      continue;
+    }
+    if (result.empty() || statistics.median() < result.median()) {
+      result = statistics;
+    }
+  }
+  return result;
+}
+
+inline results::Record make_record(
+    const results::Config& config,
+    const std::string& name,
+    const Statistics& statistics,
+    int iterations,
+    const perf::Values& counters
+) {
+  results::Record record(config, name);
+  record.median_ns = statistics.median().count();
+  record.ci_low_ns = statistics.ci_low().count();
+  record.ci_high_ns = statistics.ci_high().count();
+  record.p10_ns = statistics.percentile(10).count();
+  record.p90_ns = statistics.percentile(90).count();
+  record.mad_ns = statistics.mad().count();
+  record.ns_per_value = record.median_ns / static_cast<double>(config.values);
+  record.samples = statistics.size() + statistics.outliers();
+  record.outliers = statistics.outliers();
+  record.iterations = iterations;
+
+  const double values = static_cast<double>(record.samples) *
+      iterations * static_cast<double>(config.values);
+  auto per_value = [&](int event) {
+    return counters.available(event) ? counters[event] / values : -1.0;
+  };
+  record.cycles = per_value(perf::CYCLES);
+  record.instructions = per_value(perf::INSTRUCTIONS);
+  record.branch_misses = per_value(perf::BRANCH_MISSES);
+  record.l1d_misses = per_value(perf::L1D_MISSES);
+  record.llc_misses = per_value(perf::LLC_MISSES);
+  if (record.cycles > 0 && record.instructions >= 0) {
+    record.ipc = record.instructions / record.cycles;
+  }
+  return record;
+}
+
+// Line of results:
+//   * (!) - the best of the group (see Task::group)
+//   * (+N%) - significantly slower than the best
+//   * (~N%) - difference with the best is not significant
+inline void print_result(
+    const results::Record& record,
+    const Statistics& statistics,
+    const Statistics& best
+) {
+  std::string output_name;
+  const double overhead = (best.median().count() == 0) ? 0 :
+      100 * (statistics.median() - best.median()) / best.median();
+  if (statistics.median() == best.median()) {
+    output_name += "(!)";
+  }
+  else if (best.significantly_faster(statistics)) {
+    output_name += "(+" + std::to_string(static_cast<int>(overhead)) + "%)";
+  }
+  else {
+    output_name += "(~" + std::to_string(static_cast<int>(overhead)) + "%)";
+  }
+
+  output_name += " ";
+  output_name += record.algo;
+
+  const uint64_t conv_ops = record.samples *
+      static_cast<uint64_t>(record.iterations) * record.values;
+
+  std::cout << std::setw(40) << output_name << " [";
+  std::cout << "median:" << record.median_ns << " ";
+  std::cout << "ci95:" << record.ci_low_ns << ".." << record.ci_high_ns << " ";
+  std::cout << "p10:" << record.p10_ns << " ";
+  std::cout << "p90:" << record.p90_ns << " ";
+  std::cout << "mad:" << record.mad_ns << " ";
+  std::cout << "ns/value:" << record.ns_per_value << " ";
+  std::cout << "outliers:" << record.outliers << " ";
+  std::cout << "runs:" << record.samples << " ";
+  std::cout << "conv_ops:" << conv_ops;
+
+  // performance counters per value, if available
+  const std::pair<const char*, double> counters[] = {
+      {"cycles", record.cycles},
+      {"instructions", record.instructions},
+      {"ipc", record.ipc},
+      {"branch_misses", record.branch_misses},
+      {"l1d_misses", record.l1d_misses},
+      {"llc_misses", record.llc_misses}
+  };
+  for (auto& i: counters) {
+    if (i.second >= 0) {
+      std::cout << " " << i.first << ":" << i.second;
+    }
+  }
+  std::cout << "]" << std::endl;
+}
+
+// Print results of enabled tasks, add them to results file
+// (see Results.hpp)
+inline void output_results(
+    const std::vector<Task*>& tasks, const results::Config& config
+) {
+  std::cout << "Results: " << std::endl;
+  for (auto task: tasks) {
+    const Statistics statistics = task->statistics();
+    if (statistics.empty()) {
+      continue;
+    }
+    const Statistics best_statistics = best(tasks, task->group());
+    const results::Record record =
+        make_record(
+            config,
+            task->name(),
+            statistics,
+            task->iterations(),
+            task->counters()
+        );
+    print_result(record, statistics, best_statistics);
+    results::writer().add(record);
+  }
+}
+
+} // namespace benchmark
+
+#endif // BENCHMARK_HPP_
@@ -0,0 +1,281 @@
+#ifndef COALESCER_HPP_
+#define COALESCER_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::copy
+#include <atomic>
+#include <cassert> // assert
+#include <condition_variable>
+#include <deque>
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Separator.hpp"
+#include "Timer.hpp"
+#include "twopass.hpp"
+
+// Front-end for many tiny format jobs (1..12 values): jobs are coalesced
+// into batches by the submitting thread, batches are drained by worker
+// pool. Every worker has its own queue: batch is sent to an idle worker
+// (any worker if all are busy), owner takes the newest batch of its queue,
+// worker with empty queue steals the oldest batch of other queue before
+// going to sleep. Values of all jobs of the batch converted by one kernel
+// loop (see twopass.hpp), text split to job sinks by precomputed lengths:
+// call/queue/wake-up overhead paid per batch instead of per job (latency
+// of the job grows with batch size).
+namespace coalesce {
+
+// `values` converted to `sink` as by `AlgoCounting::run<Separator>`
+template <class Integer>
+class Job {
+ public:
+  std::vector<Integer> values;
+  char* sink;
+
+  Timer::TimePoint submitted;
+  Timer::TimePoint finished;
+};
+
+template <class Integer, class Separator = separator::None>
+class Pool {
+ public:
+  using job_t = Job<Integer>;
+
+  Pool(unsigned threads, size_t batch_size):
+      batch_size_(batch_size),
+      next_worker_(0),
+      submitted_(0),
+      finished_(0),
+      steals_(0) {
+    assert(threads > 0);
+    assert(batch_size > 0);
+
+    for (unsigned i = 0; i < threads; ++i) {
+      workers_.emplace_back(new Worker);
+    }
+    try {
+      for (unsigned i = 0; i < threads; ++i) {
+        workers_[i]->thread = std::thread(&Pool::work, this, i);
+      }
+    }
+    catch (...) {
+      // started workers joined, no `std::terminate` by `std::thread`
+      stop();
+      throw;
+    }
+  }
+
+  ~Pool() {
+    stop();
+  }
+
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+
+  // Single submitting thread. Job must be alive until `wait`
+  void submit(job_t& job) {
+    job.submitted = Timer::now();
+    pending_.push_back(&job);
+    ++submitted_;
+    if (pending_.size() >= batch_size_) {
+      flush();
+    }
+  }
+
+  // Send incomplete batch to workers
+  void flush() {
+    if (pending_.empty()) {
+      return;
+    }
+
+    // idle worker if any, otherwise the next one
+    const size_t size = workers_.size();
+    size_t index = next_worker_;
+    for (size_t i = 0; i < size; ++i) {
+      const size_t candidate = (next_worker_ + i) % size;
+      if (workers_[candidate]->idle.load(std::memory_order_relaxed)) {
+        index = candidate;
+        break;
+      }
+    }
+    next_worker_ = (index + 1) % size;
+
+    Worker& worker = *workers_[index];
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.batches.emplace_back();
+      worker.batches.back().swap(pending_);
+    }
+    worker.wake.notify_one();
+    pending_.reserve(batch_size_);
+  }
+
+  // All submitted jobs finished
+  void wait() {
+    flush();
+    while (finished_.load(std::memory_order_acquire) != submitted_) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Batches taken from queue of other worker
+  size_t steals() const {
+    return steals_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  using Batch = std::vector<job_t*>;
+
+  class Worker {
+   public:
+    Worker(): stop(false), idle(false) {
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Batch> batches;
+    bool stop;
+
+    // hint for `flush`: waiting for batch
+    std::atomic<bool> idle;
+
+    std::thread thread;
+  };
+
+  // Buffers of `run`, reused by next batches of the worker
+  class Scratch {
+   public:
+    std::vector<Integer> values;
+    twopass::Offsets offsets;
+    std::vector<char> text;
+  };
+
+  void stop() {
+    for (auto& i: workers_) {
+      {
+        std::lock_guard<std::mutex> lock(i->mutex);
+        i->stop = true;
+      }
+      i->wake.notify_one();
+    }
+    for (auto& i: workers_) {
+      if (i->thread.joinable()) {
+        i->thread.join();
+      }
+    }
+  }
+
+  // Oldest batch of other worker
+  bool steal(unsigned index, Batch& batch) {
+    const size_t size = workers_.size();
+    for (size_t i = 1; i < size; ++i) {
+      Worker& worker = *workers_[(index + i) % size];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (worker.batches.empty()) {
+        continue;
+      }
+      batch.swap(worker.batches.front());
+      worker.batches.pop_front();
+      steals_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  // Newest batch of own queue, stolen batch or wait for batch.
+  // False: stop requested and own queue is empty.
+  bool pop(unsigned index, Batch& batch) {
+    Worker& self = *workers_[index];
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (!self.batches.empty()) {
+          batch.swap(self.batches.back());
+          self.batches.pop_back();
+          return true;
+        }
+      }
+
+      if (steal(index, batch)) {
+        return true;
+      }
+
+      std::unique_lock<std::mutex> lock(self.mutex);
+      self.idle.store(true, std::memory_order_relaxed);
+      self.wake.wait(lock, [&self]() {
+        return self.stop || !self.batches.empty();
+      });
+      self.idle.store(false, std::memory_order_relaxed);
+      if (self.batches.empty()) {
+        // stop
+        return false;
+      }
+    }
+  }
+
+  void work(unsigned index) {
+    Batch batch;
+    Scratch scratch;
+    while (pop(index, batch)) {
+      run(batch, scratch);
+      finished_.fetch_add(batch.size(), std::memory_order_release);
+      batch.clear();
+    }
+  }
+
+  // One kernel loop over values of all jobs of the batch
+  static void run(const Batch& batch, Scratch& scratch) {
+    std::vector<Integer>& values = scratch.values;
+    values.clear();
+    for (auto job: batch) {
+      values.insert(values.end(), job->values.begin(), job->values.end());
+    }
+
+    // text of the jobs, separated by `Separator` as values are
+    const size_t total = twopass::count<Separator>(values, scratch.offsets);
+    scratch.text.resize(total);
+    twopass::write<Separator>(scratch.text.data(), values, scratch.offsets);
+
+    // split by offsets, separator between jobs dropped
+    const twopass::Offsets& offsets = scratch.offsets;
+    size_t first = 0;
+    for (auto job: batch) {
+      const size_t last = first + job->values.size();
+      const size_t begin = offsets[first];
+      size_t end = offsets[last];
+      if (first != last && last != values.size()) {
+        end -= Separator::size;
+      }
+      std::copy(
+          scratch.text.begin() + begin, scratch.text.begin() + end, job->sink
+      );
+      job->sink[end - begin] = '\0';
+      first = last;
+    }
+
+    const Timer::TimePoint now = Timer::now();
+    for (auto job: batch) {
+      job->finished = now;
+    }
+  }
+
+  const size_t batch_size_;
+
+  // submitting thread only
+  Batch pending_;
+  size_t next_worker_;
+  size_t submitted_;
+
+  std::atomic<size_t> finished_;
+  std::atomic<size_t> steals_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace coalesce
+
+#endif // COALESCER_HPP_
@@ -0,0 +1,52 @@
+#ifndef COLUMN_RUNNER_HPP_
+#define COLUMN_RUNNER_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::runtime_error
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+// Values of `Input` converted to column of strings by `Builder`
+// (see Columns.hpp). Every sample ends with check of every string.
+template <class Input, class Builder>
+class ColumnRunner: public benchmark::SampledTask {
+ public:
+  ColumnRunner(const Input& input, const char* name):
+      benchmark::SampledTask(name),
+      input_(input)
+  {
+    for (auto& i: input_.values()) {
+      std::ostringstream stream;
+      stream << i;
+      expected_.push_back(stream.str());
+    }
+  }
+
+  // One sample, first call: warm-up and calibration
+  void run() override {
+    sample([this]() {
+      Builder::run(input_.values(), result_);
+
+      // prevent compiler optimization
+      benchmark::escape(&result_);
+    });
+
+    for (size_t i = 0; i < expected_.size(); ++i) {
+      if (Builder::value(result_, i) != expected_[i]) {
+        throw std::runtime_error(std::string("Incorrect column: ") + name());
+      }
+    }
+  }
+
+ private:
+  const Input& input_;
+  std::vector<std::string> expected_;
+  typename Builder::result_t result_;
+};
+
+#endif // COLUMN_RUNNER_HPP_
@@ -0,0 +1,89 @@
+#ifndef COLUMNS_HPP_
+#define COLUMNS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstdint> // int32_t, int64_t
+#include <string>
+#include <vector>
+
+#include "Int128.hpp"
+#include "IsSupported.hpp"
+#include "columnar.hpp"
+
+// Vector of values converted to column of strings (see ColumnRunner.hpp):
+// `result_t`, `run(in, result)` and `value(result, i)` - text of value `i`.
+// Result of previous run reused, benchmark measures formatting, not
+// allocation of the column. Arrow columns are only resized by `convert`:
+// every byte is overwritten, clear + resize would zero them first.
+
+template <class Offset>
+class ColumnArrow {
+ public:
+  using result_t = columnar::Column<Offset>;
+
+  template <class Vector>
+  static void run(const Vector& in, result_t& result) {
+    columnar::convert(in, result);
+  }
+
+  static std::string value(const result_t& result, size_t i) {
+    const char* data = result.data.data();
+    return std::string(data + result.offsets[i], data + result.offsets[i + 1]);
+  }
+};
+
+class ColumnInt32: public ColumnArrow<int32_t> {
+ public:
+  static const char* name() {
+    return "column_int32";
+  }
+};
+
+class ColumnInt64: public ColumnArrow<int64_t> {
+ public:
+  static const char* name() {
+    return "column_int64";
+  }
+};
+
+// Allocation per value (vector of strings reused, strings are not): path
+// replaced by columns
+class ColumnToString {
+ public:
+  using result_t = std::vector<std::string>;
+
+  static const char* name() {
+    return "to_string";
+  }
+
+  template <class Vector>
+  static void run(const Vector& in, result_t& result) {
+    result.clear();
+    for (auto& i: in) {
+      result.push_back(std::to_string(i));
+    }
+  }
+
+  static std::string value(const result_t& result, size_t i) {
+    return result[i];
+  }
+};
+
+#if HAVE_INT128
+// No 128-bit `std::to_string`
+template <>
+class IsSupported<ColumnToString, int128_t> {
+ public:
+  static const bool value = false;
+};
+
+template <>
+class IsSupported<ColumnToString, uint128_t> {
+ public:
+  static const bool value = false;
+};
+#endif
+
+#endif // COLUMNS_HPP_
@@ -2,6 +2,9 @@
 #define COUNT_DIGITS_HPP_
 
 #include <cstddef> // size_t
+#include <type_traits> // std::conditional
+
+#include "Int128.hpp"
 
 // Copyright (c) 2014, Ruslan Baratov
 // All rights reserved.
@@ -12,19 +15,34 @@ class Power10;
 template <>
 class Power10<0> {
  public:
-  static const unsigned long long value = 1;
+  using value_type = unsigned long long;
+
+  static const value_type value = 1;
 };
 
+// 10^20 and above doesn't fit `unsigned long long`
 template <int power>
 class Power10 {
  public:
   static_assert(power > 0, "");
 
-  static const unsigned long long value = 10ull * Power10<power - 1>::value;
+#if HAVE_INT128
+  static_assert(power <= 38, "");
+  using value_type = typename std::conditional<
+      (power < 20), unsigned long long, uint128_t
+  >::type;
+#else
+  static_assert(power < 20, "");
+  using value_type = unsigned long long;
+#endif
+
+  static const value_type value =
+      static_cast<value_type>(10) * Power10<power - 1>::value;
 };
 
 // Count decimal digits of value without using division operation.
-// Bisection algorithm used (maximum number of comparisons is 5 for uint64)
+// Bisection algorithm used (maximum number of comparisons is 5 for uint64,
+// 6 for uint128)
 
 // max - maximum boundary value that need to be checked, i.e.
 //   * value definitely lower than 10^(max+1)
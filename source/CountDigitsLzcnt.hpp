@@ -0,0 +1,115 @@
+#ifndef COUNT_DIGITS_LZCNT_HPP_
+#define COUNT_DIGITS_LZCNT_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <type_traits> // std::is_unsigned
+
+#if defined(_MSC_VER)
+# include <intrin.h> // _BitScanReverse, _BitScanReverse64
+#endif
+
+#include "Int128.hpp"
+
+// Count decimal digits without branches (Hacker's Delight, 11-4):
+//   t = floor(bits(value) * log10(2)) ~ (bits * 1233) >> 12
+//   digits = t + (value >= 10^t)
+// `bits` - position of the highest set bit, count leading zeros
+// instruction (`lzcnt`/`bsr`). One table lookup and one compare instead
+// of bisection (see CountDigits.hpp).
+class CountDigitsLzcnt {
+ public:
+  template <class Unsigned>
+  static size_t count(Unsigned value) {
+    static_assert(std::is_unsigned<Unsigned>::value, "");
+    static_assert(sizeof(Unsigned) <= sizeof(uint64_t), "");
+
+    const uint64_t x = static_cast<uint64_t>(value) | 1; // 0 has 1 digit
+    const int t = (bits(x) * 1233) >> 12;
+    return static_cast<size_t>(t) + (x >= powers_64()[t]);
+  }
+
+#if HAVE_INT128
+  static size_t count(uint128_t value) {
+    const uint128_t x = value | 1;
+    const uint64_t high = static_cast<uint64_t>(x >> 64);
+    const int total_bits =
+        (high != 0) ? 64 + bits(high) : bits(static_cast<uint64_t>(x));
+    const int t = (total_bits * 1233) >> 12;
+    return static_cast<size_t>(t) + (x >= powers_128()[t]);
+  }
+#endif
+
+  // Number of significant bits, `value != 0`
+  static int bits(uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index) + 1;
+#elif defined(_MSC_VER)
+    // 32-bit: no `_BitScanReverse64`, high word first
+    unsigned long index;
+    if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32))) {
+      return static_cast<int>(index) + 33;
+    }
+    _BitScanReverse(&index, static_cast<unsigned long>(value));
+    return static_cast<int>(index) + 1;
+#else
+    return 64 - __builtin_clzll(value);
+#endif
+  }
+
+ private:
+  // 10^0 .. 10^19
+  static const uint64_t* powers_64() {
+    static const uint64_t result[] = {
+        1ull,
+        10ull,
+        100ull,
+        1000ull,
+        10000ull,
+        100000ull,
+        1000000ull,
+        10000000ull,
+        100000000ull,
+        1000000000ull,
+        10000000000ull,
+        100000000000ull,
+        1000000000000ull,
+        10000000000000ull,
+        100000000000000ull,
+        1000000000000000ull,
+        10000000000000000ull,
+        100000000000000000ull,
+        1000000000000000000ull,
+        10000000000000000000ull
+    };
+    return result;
+  }
+
+#if HAVE_INT128
+  static constexpr uint128_t power(int n) {
+    return (n == 0) ? 1 : 10 * power(n - 1);
+  }
+
+  // 10^0 .. 10^38 (static initialization)
+  static const uint128_t* powers_128() {
+    static const uint128_t result[] = {
+        power(0), power(1), power(2), power(3), power(4),
+        power(5), power(6), power(7), power(8), power(9),
+        power(10), power(11), power(12), power(13), power(14),
+        power(15), power(16), power(17), power(18), power(19),
+        power(20), power(21), power(22), power(23), power(24),
+        power(25), power(26), power(27), power(28), power(29),
+        power(30), power(31), power(32), power(33), power(34),
+        power(35), power(36), power(37), power(38)
+    };
+    return result;
+  }
+#endif
+};
+
+#endif // COUNT_DIGITS_LZCNT_HPP_
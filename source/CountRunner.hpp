@@ -0,0 +1,108 @@
+#ifndef COUNT_RUNNER_HPP_
+#define COUNT_RUNNER_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <limits> // std::numeric_limits
+#include <stdexcept> // std::runtime_error
+#include <string>
+#include <type_traits> // std::make_unsigned
+
+#include "Benchmark.hpp"
+
+// Digit counting alone (first step of `counting`/`alexandrescu`): length of
+// text of every value of `Input` summed. Every sample ends with check of
+// the sum.
+template <class Input, class Counter>
+class CountRunner: public benchmark::SampledTask {
+ public:
+  CountRunner(const Input& input, const char* name):
+      benchmark::SampledTask(name),
+      input_(input),
+      expected_(0)
+  {
+#if !defined(NDEBUG)
+    test_counter();
+#endif
+    for (auto& i: input_.values()) {
+      expected_ += text_size(i);
+    }
+  }
+
+  // One sample, first call: warm-up and calibration
+  void run() override {
+    size_t total = 0;
+    sample([this, &total]() {
+      total = count(input_.values());
+
+      // prevent compiler optimization
+      benchmark::escape(&total);
+    });
+
+    if (total != expected_) {
+      throw std::runtime_error(std::string("Incorrect count: ") + name());
+    }
+  }
+
+ private:
+  using value_t = typename Input::value_t;
+  using Unsigned = typename std::make_unsigned<value_t>::type;
+  using Vector = typename Input::Vector;
+
+  static size_t count(const Vector& in) {
+    size_t total = 0;
+    for (auto input_value: in) {
+      const bool negative = (input_value < 0);
+      const Unsigned value = negative ?
+          0 - static_cast<Unsigned>(input_value) :
+          static_cast<Unsigned>(input_value);
+      total += negative + Counter::count(value);
+    }
+    return total;
+  }
+
+  // Reference: division by 10
+  static size_t text_size(value_t input_value) {
+    Unsigned value = static_cast<Unsigned>(input_value);
+    size_t result = 1;
+    if (input_value < 0) {
+      value = 0 - value;
+      ++result;
+    }
+    while (value >= 10) {
+      value /= 10;
+      ++result;
+    }
+    return result;
+  }
+
+  // 10^k - 1, 10^k, 10^k + 1 and limits
+  void test_counter() const {
+    Vector values{
+        0,
+        std::numeric_limits<value_t>::max(),
+        std::numeric_limits<value_t>::min()
+    };
+    const Unsigned max = std::numeric_limits<value_t>::max();
+    for (Unsigned power = 1; ; power = static_cast<Unsigned>(power * 10)) {
+      values.push_back(static_cast<value_t>(power - 1));
+      values.push_back(static_cast<value_t>(power));
+      values.push_back(static_cast<value_t>(power + 1));
+      values.push_back(static_cast<value_t>(0 - power));
+      if (power > max / 10) {
+        break;
+      }
+    }
+    for (auto& i: values) {
+      if (count(Vector(1, i)) != text_size(i)) {
+        throw std::runtime_error(std::string("Incorrect counter: ") + name());
+      }
+    }
+  }
+
+  const Input& input_;
+  size_t expected_;
+};
+
+#endif // COUNT_RUNNER_HPP_
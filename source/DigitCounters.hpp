@@ -0,0 +1,51 @@
+#ifndef DIGIT_COUNTERS_HPP_
+#define DIGIT_COUNTERS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include "CountDigitsLzcnt.hpp"
+#include "alexandrescu.hpp"
+#include "counting.hpp"
+
+// Number of decimal digits of unsigned value (see CountRunner.hpp).
+// Same policies are used by `counting::generate` and
+// `alexandrescu::generate`.
+
+class CounterBisection {
+ public:
+  static const char* name() {
+    return "count_bisection";
+  }
+
+  template <class Unsigned>
+  static size_t count(Unsigned value) {
+    return counting::Bisection::count(value);
+  }
+};
+
+class CounterTree {
+ public:
+  static const char* name() {
+    return "count_tree";
+  }
+
+  template <class Unsigned>
+  static size_t count(Unsigned value) {
+    return alexandrescu::Tree::count(value);
+  }
+};
+
+class CounterLzcnt {
+ public:
+  static const char* name() {
+    return "count_lzcnt";
+  }
+
+  template <class Unsigned>
+  static size_t count(Unsigned value) {
+    return CountDigitsLzcnt::count(value);
+  }
+};
+
+#endif // DIGIT_COUNTERS_HPP_
@@ -0,0 +1,268 @@
+#ifndef DISPATCH_HPP_
+#define DISPATCH_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::min
+#include <cassert> // assert
+#include <cstdlib> // std::getenv
+#include <fstream> // std::ifstream
+#include <limits> // std::numeric_limits
+#include <map>
+#include <random> // std::mt19937_64
+#include <string>
+#include <vector>
+
+#include "Algos.hpp"
+#include "Int128.hpp"
+#include "Separator.hpp"
+#include "Timer.hpp"
+
+// Runtime selection of the fastest kernel: CPU features checked once,
+// kernels from Algos.hpp (correct output only) timed on a sample and
+// the winner bound to a function pointer. Choice can be saved to cache
+// file (one line per type/separator/CPU features), next start reads it
+// instead of calibration.
+namespace dispatch {
+
+// CPU features which enable additional kernels, e.g. "sse4.1"
+inline std::string cpu_features() {
+  return simd::enabled() ? "sse4.1" : "generic";
+}
+
+// "int64", "uint16", ...
+template <class Integer>
+inline std::string type_name() {
+  const int bits = std::numeric_limits<Integer>::digits +
+      (std::numeric_limits<Integer>::is_signed ? 1 : 0);
+  return (std::numeric_limits<Integer>::is_signed ? "int" : "uint") +
+      std::to_string(bits);
+}
+
+// Text file, line: "<key> <kernel name>", lines starting with '#' ignored.
+// Cache is optional: read/write errors are not reported.
+class Cache {
+ public:
+  explicit Cache(const std::string& path): path_(path) {
+    std::ifstream file(path_);
+    std::string line;
+    while (std::getline(file, line)) {
+      const size_t space = line.rfind(' ');
+      if (line.empty() || line[0] == '#' || space == std::string::npos) {
+        continue;
+      }
+      entries_[line.substr(0, space)] = line.substr(space + 1);
+    }
+  }
+
+  std::string find(const std::string& key) const {
+    auto it = entries_.find(key);
+    return (it == entries_.end()) ? std::string() : it->second;
+  }
+
+  void save(const std::string& key, const std::string& name) {
+    entries_[key] = name;
+    std::ofstream file(path_);
+    file << "# int_dec_format dispatch cache: <type/separator/cpu> <kernel>\n";
+    for (auto& i: entries_) {
+      file << i.first << " " << i.second << "\n";
+    }
+  }
+
+ private:
+  const std::string path_;
+  std::map<std::string, std::string> entries_;
+};
+
+template <class Integer, class Separator = separator::None>
+class Dispatcher {
+ public:
+  using Vector = std::vector<Integer>;
+
+  // Convert all values of `in`, `Separator` between values,
+  // terminating '\0', return position of '\0' (as `Algo*::run`)
+  using Kernel = char* (*)(char* buffer, const Vector& in);
+
+  enum {
+    SAMPLE_SIZE = 1024,
+    TIMED_RUN = 5,
+    TIMER_ITERATIONS = 10
+  };
+
+  // Empty `cache_path`: no cache, always calibrate
+  explicit Dispatcher(const std::string& cache_path = ""):
+      kernel_(nullptr),
+      from_cache_(false),
+      calibration_(0) {
+    const std::string key =
+        type_name<Integer>() + "/" + Separator::name() + "/" + cpu_features();
+
+    if (!cache_path.empty()) {
+      Cache cache(cache_path);
+      if (bind(cache.find(key))) {
+        from_cache_ = true;
+        return;
+      }
+    }
+
+    calibrate(make_sample());
+
+    if (!cache_path.empty()) {
+      Cache cache(cache_path);
+      cache.save(key, name_);
+    }
+  }
+
+  char* run(char* buffer, const Vector& in) const {
+    return kernel_(buffer, in);
+  }
+
+  Kernel kernel() const {
+    return kernel_;
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  bool from_cache() const {
+    return from_cache_;
+  }
+
+  Timer::Duration calibration() const {
+    return calibration_;
+  }
+
+ private:
+  class Candidate {
+   public:
+    const char* name;
+    Kernel kernel;
+    bool available;
+  };
+
+  static std::vector<Candidate> candidates() {
+    return {
+        {AlgoCounting::name(), &AlgoCounting::run<Separator, Vector>, true},
+        {AlgoReverse::name(), &AlgoReverse::run<Separator, Vector>, true},
+        {AlgoTmpbuf::name(), &AlgoTmpbuf::run<Separator, Vector>, true},
+        {AlgoAlexandrescu::name(), &AlgoAlexandrescu::run<Separator, Vector>, true},
+        {AlgoReciprocal::name(), &AlgoReciprocal::run<Separator, Vector>, true},
+        {AlgoSwar::name(), &AlgoSwar::run<Separator, Vector>, true},
+        {AlgoSimd::name(), &AlgoSimd::run<Separator, Vector>, simd::enabled()}
+    };
+  }
+
+  // Any number of digits, with sign (if signed)
+  static Vector make_sample() {
+    std::mt19937_64 generator;
+    std::uniform_int_distribution<Integer> distribution(
+        std::numeric_limits<Integer>::min(), std::numeric_limits<Integer>::max()
+    );
+    Vector sample(SAMPLE_SIZE);
+    for (auto& i: sample) {
+      i = distribution(generator);
+    }
+    return sample;
+  }
+
+  static size_t buffer_size(const Vector& in) {
+    return in.size() * (
+        std::numeric_limits<Integer>::digits10 +
+        1 + // rounding error
+        1 + // sign
+        Separator::size
+    ) + 1 + // terminate
+        8; // stores after the end of number (see simd.hpp)
+  }
+
+  bool bind(const std::string& name) {
+    for (auto& i: candidates()) {
+      if (i.available && name == i.name) {
+        kernel_ = i.kernel;
+        name_ = i.name;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Best of `TIMED_RUN` runs, kernels with wrong output skipped.
+  // `counting` is a reference and always correct.
+  void calibrate(const Vector& sample) {
+    const Timer::TimePoint start = Timer::now();
+
+    std::vector<char> expected(buffer_size(sample));
+    AlgoCounting::run<Separator>(expected.data(), sample);
+    const std::string expected_str(expected.data());
+
+    std::vector<char> buffer(expected.size());
+    Timer::Duration best = Timer::Duration::max();
+
+    for (auto& candidate: candidates()) {
+      if (!candidate.available) {
+        continue;
+      }
+
+      candidate.kernel(buffer.data(), sample);
+      if (std::string(buffer.data()) != expected_str) {
+        continue;
+      }
+
+      Timer::Duration candidate_best = Timer::Duration::max();
+      for (int i = 0; i < TIMED_RUN; ++i) {
+        const Timer::TimePoint run_start = Timer::now();
+        for (int j = 0; j < TIMER_ITERATIONS; ++j) {
+          candidate.kernel(buffer.data(), sample);
+        }
+        candidate_best = std::min(candidate_best, Timer::now() - run_start);
+      }
+
+      if (candidate_best < best) {
+        best = candidate_best;
+        kernel_ = candidate.kernel;
+        name_ = candidate.name;
+      }
+    }
+
+    assert(kernel_ != nullptr);
+    calibration_ = Timer::now() - start;
+  }
+
+  Kernel kernel_;
+  std::string name_;
+  bool from_cache_;
+  Timer::Duration calibration_;
+};
+
+// Dispatcher created on first use, cache file path from environment
+// variable INT_DEC_DISPATCH_CACHE (not set: no cache)
+template <class Integer, class Separator>
+inline const Dispatcher<Integer, Separator>& instance() {
+  static const char* cache_path = std::getenv("INT_DEC_DISPATCH_CACHE");
+  static const Dispatcher<Integer, Separator> result(
+      cache_path == nullptr ? "" : cache_path
+  );
+  return result;
+}
+
+} // namespace dispatch
+
+// Kernel selected at runtime (called by pointer)
+class AlgoDispatch {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "dispatch";
+  }
+
+  template <class Separator = separator::None, class Vector>
+  static char* run(char* buffer, const Vector& in) {
+    using Integer = typename Vector::value_type;
+    return dispatch::instance<Integer, Separator>().run(buffer, in);
+  }
+};
+
+#endif // DISPATCH_HPP_
@@ -0,0 +1,419 @@
+#ifndef DISTRIBUTION_HPP_
+#define DISTRIBUTION_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::min
+#include <cassert> // assert
+#include <cmath> // std::pow, std::log
+#include <fstream> // std::ifstream
+#include <limits> // std::numeric_limits
+#include <random> // std::mt19937_64
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::runtime_error
+#include <string>
+#include <vector>
+
+#include "Int128.hpp"
+
+// Values of `Input` (see Input.hpp), name "kind" or "kind:parameter":
+//   * uniform - `digit` digits (0: full range of type)
+//   * log_uniform - number of digits uniform, then value uniform
+//   * zipf:S - value k with probability ~ 1/k^S (IDs), default 1.1
+//   * geometric:P - small counters, mean (1 - P) / P, 0 < P < 1, default 0.01
+//   * monotone:D - increasing by uniform step 0..D (row numbers,
+//     timestamps), default 100
+//   * mixed_sign:R - log_uniform, negative with probability R, default 0.1
+//   * file:PATH - values from text file (decimal, separated by
+//     whitespaces), repeated to fill input; without sign: absolute values
+// `digit` and `same_size` are used by `uniform` only, other
+// distributions are tested with ANY digits.
+class Distribution {
+ public:
+  enum Kind {
+    UNIFORM,
+    LOG_UNIFORM,
+    ZIPF,
+    GEOMETRIC,
+    MONOTONE,
+    MIXED_SIGN,
+    FILE
+  };
+
+  explicit Distribution(const std::string& name = "uniform") {
+    const size_t colon = name.find(':');
+    const std::string kind = name.substr(0, colon);
+    const bool have_parameter = (colon != std::string::npos);
+    const std::string parameter =
+        have_parameter ? name.substr(colon + 1) : std::string();
+
+    if (kind == "file") {
+      if (parameter.empty()) {
+        throw std::runtime_error("Expected file:PATH distribution");
+      }
+      kind_ = FILE;
+      parameter_ = 0;
+      load(parameter);
+      name_ = name;
+      return;
+    }
+
+    struct Known {
+      const char* name;
+      Kind kind;
+      double parameter;
+    };
+    const Known known[] = {
+        {"uniform", UNIFORM, 0},
+        {"log_uniform", LOG_UNIFORM, 0},
+        {"zipf", ZIPF, 1.1},
+        {"geometric", GEOMETRIC, 0.01},
+        {"monotone", MONOTONE, 100},
+        {"mixed_sign", MIXED_SIGN, 0.1}
+    };
+
+    for (auto& i: known) {
+      if (kind != i.name) {
+        continue;
+      }
+      kind_ = i.kind;
+      parameter_ = i.parameter;
+      name_ = kind;
+      if (i.parameter == 0) {
+        if (have_parameter) {
+          throw std::runtime_error("No parameter expected: " + name);
+        }
+        return;
+      }
+      if (have_parameter) {
+        parameter_ = std::stod(parameter);
+      }
+      check_parameter(name);
+      name_ += ":" + number(parameter_);
+      return;
+    }
+
+    throw std::runtime_error("Unknown distribution: " + name);
+  }
+
+  // Names of built-in distributions (`file` excluded)
+  static std::vector<std::string> defaults() {
+    return {
+        "uniform", "log_uniform", "zipf", "geometric", "monotone", "mixed_sign"
+    };
+  }
+
+  Kind kind() const {
+    return kind_;
+  }
+
+  // Canonical name, e.g. "zipf:1.1"
+  const std::string& name() const {
+    return name_;
+  }
+
+  // Input parameters used by distribution
+  bool is_applicable(int digit, bool have_sign, bool same_size) const {
+    if (kind_ == UNIFORM) {
+      return true;
+    }
+    if (digit != 0 || same_size) {
+      return false;
+    }
+    if (kind_ == MONOTONE) {
+      return !have_sign;
+    }
+    if (kind_ == MIXED_SIGN) {
+      return have_sign;
+    }
+    return true;
+  }
+
+  // Some values of file are in range of `Type`
+  template <class Type>
+  bool fits(bool have_sign) const {
+    if (kind_ != FILE) {
+      return true;
+    }
+    Type value = 0;
+    for (auto& i: file_values_) {
+      if (parse(i, have_sign, value)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <class Type>
+  void generate(
+      std::vector<Type>& values, int digit, bool have_sign, bool same_size
+  ) const {
+    assert(!have_sign || std::numeric_limits<Type>::is_signed);
+
+    switch (kind_) {
+      case UNIFORM:
+        generate_uniform(values, digit, have_sign, same_size);
+        return;
+      case FILE:
+        generate_file(values, have_sign);
+        return;
+      default:
+        break;
+    }
+
+    std::random_device rd;
+    std::mt19937_64 generator(rd());
+
+    switch (kind_) {
+      case LOG_UNIFORM:
+      case MIXED_SIGN:
+        for (auto& i: values) {
+          i = log_uniform<Type>(generator);
+        }
+        break;
+      case ZIPF:
+        for (auto& i: values) {
+          i = zipf<Type>(generator);
+        }
+        break;
+      case GEOMETRIC:
+        {
+          std::geometric_distribution<long long> dist(parameter_);
+          for (auto& i: values) {
+            i = clamp<Type>(static_cast<double>(dist(generator)));
+          }
+        }
+        break;
+      case MONOTONE:
+        generate_monotone(values, generator);
+        break;
+      default:
+        assert(false);
+    }
+
+    if (have_sign) {
+      std::bernoulli_distribution negative(
+          (kind_ == MIXED_SIGN) ? parameter_ : 0.5
+      );
+      for (auto& i: values) {
+        if (negative(generator)) {
+          i = -i;
+        }
+      }
+    }
+  }
+
+ private:
+  static std::string number(double value) {
+    std::ostringstream result;
+    result << value;
+    return result.str();
+  }
+
+  void check_parameter(const std::string& name) const {
+    bool ok = true;
+    switch (kind_) {
+      case ZIPF:
+        ok = (parameter_ > 0);
+        break;
+      case GEOMETRIC:
+        ok = (parameter_ > 0 && parameter_ < 1); // std::geometric_distribution
+        break;
+      case MONOTONE:
+        ok = (parameter_ >= 0 && parameter_ == std::floor(parameter_));
+        break;
+      case MIXED_SIGN:
+        ok = (parameter_ >= 0 && parameter_ <= 1);
+        break;
+      default:
+        break;
+    }
+    if (!ok) {
+      throw std::runtime_error("Bad parameter of distribution: " + name);
+    }
+  }
+
+  void load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+      throw std::runtime_error("Can't open input file: " + path);
+    }
+    std::string value;
+    while (file >> value) {
+      const size_t begin = (value[0] == '-' || value[0] == '+') ? 1 : 0;
+      if (begin == value.size() ||
+          value.find_first_not_of("0123456789", begin) != std::string::npos) {
+        throw std::runtime_error("Not a decimal in " + path + ": " + value);
+      }
+      file_values_.push_back(value);
+    }
+    if (file_values_.empty()) {
+      throw std::runtime_error("No values in input file: " + path);
+    }
+  }
+
+  // Decimal text to `Type`, false if out of range.
+  // Without sign: absolute value.
+  template <class Type>
+  static bool parse(const std::string& text, bool have_sign, Type& result) {
+    const bool negative = have_sign && (text[0] == '-');
+    size_t i = (text[0] == '-' || text[0] == '+') ? 1 : 0;
+    Type value = 0;
+    for (; i < text.size(); ++i) {
+      const Type digit = static_cast<Type>(text[i] - '0');
+      if (negative) {
+        if (value < (std::numeric_limits<Type>::min() + digit) / 10) {
+          return false;
+        }
+        value = value * 10 - digit;
+      }
+      else {
+        if (value > (std::numeric_limits<Type>::max() - digit) / 10) {
+          return false;
+        }
+        value = value * 10 + digit;
+      }
+    }
+    result = value;
+    return true;
+  }
+
+  // `value` rounded down, limited to [0, max]
+  template <class Type>
+  static Type clamp(double value) {
+    if (value <= 0) {
+      return 0;
+    }
+    if (value >= static_cast<double>(std::numeric_limits<Type>::max())) {
+      return std::numeric_limits<Type>::max();
+    }
+    return static_cast<Type>(value);
+  }
+
+  template <class Type>
+  static void generate_uniform(
+      std::vector<Type>& values, int digit, bool have_sign, bool same_size
+  ) {
+    Type max = 0;
+    Type min = 0;
+
+    if (digit != 0) {
+      max = static_cast<Type>(std::pow(10, digit) - 1);
+      min = std::numeric_limits<Type>::is_signed ? -max : 0;
+    }
+    else {
+      max = std::numeric_limits<Type>::max();
+      min = std::numeric_limits<Type>::min();
+    }
+
+    if (!have_sign) {
+      min = 0;
+    }
+
+    if (same_size) {
+      assert(!have_sign);
+      assert(digit > 0);
+      if (digit == 1) {
+        min = 0;
+      }
+      else {
+        min = static_cast<Type>(std::pow(10, digit - 1));
+      }
+    }
+
+    assert(max > min);
+
+    std::random_device rd;
+    std::uniform_int_distribution<Type> dist(min, max);
+    for (auto& i: values) {
+      i = dist(rd);
+    }
+  }
+
+  // Number of digits uniform in [1, digits of max], then value uniform
+  template <class Type, class Generator>
+  static Type log_uniform(Generator& generator) {
+    const Type max = std::numeric_limits<Type>::max();
+    const int digits = std::numeric_limits<Type>::digits10 + 1;
+
+    std::uniform_int_distribution<int> digits_dist(1, digits);
+    const int digit = digits_dist(generator);
+
+    if (digit == 1) {
+      std::uniform_int_distribution<Type> dist(0, 9);
+      return dist(generator);
+    }
+
+    Type low = 1;
+    for (int i = 1; i < digit; ++i) {
+      low *= 10;
+    }
+    const Type high = (digit == digits) ? max : low * 10 - 1;
+    std::uniform_int_distribution<Type> dist(low, high);
+    return dist(generator);
+  }
+
+  // Continuous power law on [1, max], inverse transform
+  template <class Type, class Generator>
+  Type zipf(Generator& generator) const {
+    const double n = static_cast<double>(std::numeric_limits<Type>::max());
+    std::uniform_real_distribution<double> dist(0, 1);
+    const double u = dist(generator);
+    const double s = parameter_;
+    if (s == 1) {
+      return clamp<Type>(std::exp(u * std::log(n)));
+    }
+    const double value = std::pow(
+        1 - u * (1 - std::pow(n, 1 - s)), 1 / (1 - s)
+    );
+    return clamp<Type>(value);
+  }
+
+  // Start uniform in range left for `values.size()` maximal steps
+  // (at most max/2), saturated at max
+  template <class Type, class Generator>
+  void generate_monotone(
+      std::vector<Type>& values, Generator& generator
+  ) const {
+    const Type max = std::numeric_limits<Type>::max();
+    const double room = static_cast<double>(max) -
+        parameter_ * static_cast<double>(values.size());
+    std::uniform_real_distribution<double> start_dist(
+        0, std::max(0.0, std::min(room, static_cast<double>(max) / 2))
+    );
+    std::uniform_int_distribution<long long> step_dist(
+        0, static_cast<long long>(parameter_)
+    );
+
+    Type value = clamp<Type>(start_dist(generator));
+    for (auto& i: values) {
+      i = value;
+      const Type step = clamp<Type>(static_cast<double>(step_dist(generator)));
+      value = (max - value < step) ? max : value + step;
+    }
+  }
+
+  // Values of file in range of `Type`, repeated
+  template <class Type>
+  void generate_file(std::vector<Type>& values, bool have_sign) const {
+    std::vector<Type> fit;
+    Type value = 0;
+    for (auto& i: file_values_) {
+      if (parse(i, have_sign, value)) {
+        fit.push_back(value);
+      }
+    }
+    assert(!fit.empty());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = fit[i % fit.size()];
+    }
+  }
+
+  Kind kind_;
+  double parameter_;
+  std::string name_;
+  std::vector<std::string> file_values_;
+};
+
+#endif // DISTRIBUTION_HPP_
@@ -0,0 +1,135 @@
+#ifndef FD_SINK_HPP_
+#define FD_SINK_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cerrno> // errno
+#include <cstdint> // uint64_t
+#include <limits> // std::numeric_limits
+#include <stdexcept> // std::runtime_error
+#include <vector>
+
+#if defined(_WIN32)
+# include <io.h> // _write
+#else
+# include <unistd.h> // write
+#endif
+
+#include "Separator.hpp"
+
+// Streaming sink: values are formatted into fixed size buffer,
+// buffer is written to file descriptor (file, pipe, socket, /dev/null)
+// when there is no room for the next value. Memory usage doesn't
+// depend on input size.
+class FdSink {
+ public:
+  using Iterator = char*;
+
+  enum {
+    DEFAULT_CAPACITY = 64 * 1024
+  };
+
+  explicit FdSink(int fd, size_t capacity = DEFAULT_CAPACITY):
+      fd_(fd),
+      buffer_(capacity),
+      current_(buffer_.data()),
+      bytes_written_(0) {
+    assert(capacity > 0);
+  }
+
+  FdSink(const FdSink&) = delete;
+  FdSink& operator=(const FdSink&) = delete;
+
+  // Flush if there is less than `size` bytes available,
+  // return position to write to (can be used as sink for `generate`)
+  Iterator& reserve(size_t size) {
+    assert(size <= buffer_.size());
+    if (static_cast<size_t>(end() - current_) < size) {
+      flush();
+    }
+    return current_;
+  }
+
+  // Remove `size` bytes written after the last `reserve`
+  void rollback(size_t size) {
+    assert(static_cast<size_t>(current_ - buffer_.data()) >= size);
+    current_ -= size;
+  }
+
+  void flush() {
+    const size_t size = static_cast<size_t>(current_ - buffer_.data());
+    write_all(fd_, buffer_.data(), size);
+    bytes_written_ += static_cast<uint64_t>(size);
+    current_ = buffer_.data();
+  }
+
+  // Write `size` bytes to `fd` (partial writes, interrupts)
+  static void write_all(int fd, const char* begin, size_t size) {
+    const char* end = begin + size;
+    while (begin != end) {
+      const size_t left = static_cast<size_t>(end - begin);
+#if defined(_WIN32)
+      const int result = ::_write(fd, begin, static_cast<unsigned>(left));
+#else
+      const ssize_t result = ::write(fd, begin, left);
+#endif
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error("write failed");
+      }
+      if (result == 0) {
+        // nothing written for non-empty data: no progress, never retried
+        throw std::runtime_error("write failed: no bytes written");
+      }
+      begin += result;
+    }
+  }
+
+  uint64_t bytes_written() const {
+    return bytes_written_;
+  }
+
+  size_t capacity() const {
+    return buffer_.size();
+  }
+
+  // Format all values of `in` with `generate` (e.g. counting::generate),
+  // `Separator` written between values. Data is not flushed.
+  template <class Separator, class Vector, class Generate>
+  void write(const Vector& in, Generate generate) {
+    using Integer = typename Vector::value_type;
+
+    static const size_t max_size =
+        std::numeric_limits<Integer>::digits10 +
+        1 + // rounding error
+        1 + // sign
+        Separator::size;
+
+    for (auto& i: in) {
+      Iterator& sink = reserve(max_size);
+      generate(sink, i);
+      Separator::write(sink);
+    }
+
+    if (!in.empty()) {
+      // separator is in buffer: flush only happens in `reserve`
+      rollback(Separator::size);
+    }
+  }
+
+ private:
+  Iterator end() {
+    return buffer_.data() + buffer_.size();
+  }
+
+  const int fd_;
+  std::vector<char> buffer_;
+  Iterator current_;
+  uint64_t bytes_written_;
+};
+
+#endif // FD_SINK_HPP_
@@ -0,0 +1,121 @@
+#ifndef FORMAT_HPP_
+#define FORMAT_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <iomanip> // std::setw
+#include <limits> // std::numeric_limits
+#include <ostream>
+#include <sstream> // std::ostringstream
+#include <string>
+#include <type_traits> // std::make_unsigned
+
+#include "Int128.hpp" // operator<<
+#include "padded.hpp"
+
+// Reference formatting of one value (std::ostream),
+// used to check results of algorithms
+namespace format {
+
+class Plain {
+ public:
+  template <class T>
+  static void write(std::ostream& stream, T value) {
+    stream << value;
+  }
+};
+
+// See algos/padded.hpp
+template <char pad, size_t W = padded::type_width>
+class Padded {
+ public:
+  template <class T>
+  static void write(std::ostream& stream, T value) {
+    using Width = padded::Width<T, W>;
+    using Unsigned = typename std::make_unsigned<T>::type;
+    Unsigned magnitude(value);
+    if (value < 0) {
+      magnitude = 0 - magnitude;
+    }
+
+    std::ostringstream digits;
+    digits << magnitude;
+    std::string text = digits.str();
+
+    // low digits of wider value, without leading zeros
+    if (text.size() > Width::digits) {
+      text.erase(0, text.size() - Width::digits);
+      const size_t first = text.find_first_not_of('0');
+      text.erase(0, (first == std::string::npos) ? text.size() - 1 : first);
+    }
+
+    const std::string sign = (value < 0) ? "-" : "";
+    const std::string fill(Width::value - sign.size() - text.size(), pad);
+    stream << (pad == '0' ? sign + fill + text : fill + sign + text);
+  }
+};
+
+// See algos/fixed.hpp
+template <int scale>
+class Fixed {
+ public:
+  template <class T>
+  static void write(std::ostream& stream, T value) {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    Unsigned magnitude(value);
+    if (value < 0) {
+      stream << '-';
+      magnitude = 0 - magnitude;
+    }
+
+    std::ostringstream digits;
+    digits << magnitude;
+    std::string text = digits.str();
+
+    const size_t size = static_cast<size_t>(scale);
+    if (text.size() <= size) {
+      text.insert(0, size + 1 - text.size(), '0');
+    }
+    if (size != 0) {
+      text.insert(text.size() - size, 1, '.');
+    }
+    stream << text;
+  }
+};
+
+// See algos/radix.hpp
+template <int base, bool upper = false>
+class Radix {
+ public:
+  template <class T>
+  static void write(std::ostream& stream, T value) {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    Unsigned magnitude(value);
+    const char* chars = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    std::string text;
+    do {
+      text.insert(text.begin(), chars[static_cast<int>(magnitude % base)]);
+      magnitude /= base;
+    } while (magnitude != 0);
+    stream << text;
+  }
+
+  // Maximum number of digits
+  template <class T>
+  static size_t width() {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    Unsigned magnitude = std::numeric_limits<Unsigned>::max();
+    size_t result = 0;
+    do {
+      ++result;
+      magnitude /= base;
+    } while (magnitude != 0);
+    return result;
+  }
+};
+
+} // namespace format
+
+#endif // FORMAT_HPP_
@@ -5,12 +5,16 @@
 // All rights reserved.
 
 #include <limits> // std::numeric_limits
-#include <random> // std::random_device
 
-template <class Type>
+#include "Distribution.hpp"
+#include "Int128.hpp" // operator<<
+#include "Separator.hpp"
+
+template <class Type, class SeparatorType = separator::None>
 class Input {
  public:
   using value_t = Type;
+  using separator_t = SeparatorType;
   using Vector = std::vector<value_t>;
 
   static_assert(std::numeric_limits<value_t>::is_integer, "");
@@ -20,6 +24,7 @@ class Input {
   static const size_t bytes_per_value = digits_per_value +
       1 + // rounding error
       1 + // sign
+      separator_t::size +
       1; // terminate
 
   const Vector& values() const {
@@ -30,44 +35,18 @@ class Input {
     return values().size();
   }
 
-  Input(size_t output_size, int digit, bool have_sign, bool same_size) {
+  // See Distribution.hpp
+  Input(
+      size_t output_size,
+      int digit,
+      bool have_sign,
+      bool same_size,
+      const Distribution& distribution = Distribution()
+  ) {
     values_.resize(output_size / bytes_per_value);
     assert(!values_.empty());
 
-    value_t max = 0;
-    value_t min = 0;
-
-    if (digit != 0) {
-      max = static_cast<value_t>(std::pow(10, digit) - 1);
-      min = -max;
-    }
-    else {
-      max = std::numeric_limits<value_t>::max();
-      min = std::numeric_limits<value_t>::min();
-    }
-
-    if (!have_sign) {
-      min = 0;
-    }
-
-    if (same_size) {
-      assert(!have_sign);
-      assert(digit > 0);
-      if (digit == 1) {
-        min = 0;
-      }
-      else {
-        min = static_cast<value_t>(std::pow(10, digit - 1));
-      }
-    }
-
-    assert(max > min);
-
-    std::random_device rd;
-    std::uniform_int_distribution<value_t> dist(min, max);
-    for (auto& i: values_) {
-      i = dist(rd);
-    }
+    distribution.generate(values_, digit, have_sign, same_size);
 
 #if !defined(NDEBUG)
     std::cout << "Input: ";
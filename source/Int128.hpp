@@ -0,0 +1,133 @@
+#ifndef INT128_HPP_
+#define INT128_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstdint> // uint64_t
+#include <type_traits> // std::conditional
+
+// 128-bit integers: GCC/Clang extension, 64-bit targets only.
+// Note that libstdc++ has no `std::numeric_limits`/`std::make_unsigned`
+// for __int128 in strict ANSI mode, GNU dialect used (see CMakeLists.txt)
+#if defined(__SIZEOF_INT128__) && \
+    !(defined(__GLIBCXX__) && defined(__STRICT_ANSI__))
+# define HAVE_INT128 1
+#else
+# define HAVE_INT128 0
+#endif
+
+#if HAVE_INT128
+
+#include <ios> // std::streamsize
+#include <ostream>
+#include <string>
+
+using int128_t = __int128;
+using uint128_t = unsigned __int128;
+
+namespace int128 {
+
+inline bool fits_64(uint128_t value) {
+  return (value >> 64) == 0;
+}
+
+// Return value / 10^19, remainder (fits 64 bits) saved to `low`.
+// Used to split 128-bit value into parts converted by 64-bit code:
+// one 128-bit division per 19 digits instead of one per digits pair
+// (divisor is 64-bit: `__udivti3` uses one or two native divisions).
+inline uint128_t divide_10_19(uint128_t value, uint64_t& low) {
+  const uint64_t divisor = 10000000000000000000ull;
+  const uint128_t result = value / divisor;
+  low = static_cast<uint64_t>(value - result * divisor);
+  return result;
+}
+
+// Exactly 19 digits of `low` part (with leading zeros) "from the end",
+// `sink` points to the position after the last digit. `pairs` - table of
+// digit pairs "00".."99" of formatter.
+inline void fill_19(char* sink, uint64_t low, const char* pairs) {
+  for (int i = 0; i < 9; ++i) {
+    const size_t index = static_cast<size_t>(low % 100) * 2; // 0..198
+    low /= 100;
+
+    --sink;
+    *sink = pairs[index + 1];
+
+    --sink;
+    *sink = pairs[index];
+  }
+
+  --sink;
+  *sink = static_cast<char>('0' + low);
+}
+
+inline std::string to_string(uint128_t value) {
+  std::string result;
+  while (!fits_64(value)) {
+    uint64_t low;
+    value = divide_10_19(value, low);
+    const std::string digits = std::to_string(low);
+    result.insert(0, digits);
+    result.insert(0, 19 - digits.size(), '0');
+  }
+  return std::to_string(static_cast<uint64_t>(value)) + result;
+}
+
+// Apply width/fill/adjustment of stream as for standard integers
+inline std::ostream& print(
+    std::ostream& stream, bool negative, const std::string& digits
+) {
+  const std::streamsize size =
+      static_cast<std::streamsize>(digits.size() + (negative ? 1 : 0));
+  const std::streamsize width = stream.width();
+  stream.width(0);
+
+  const std::string fill(
+      width > size ? static_cast<size_t>(width - size) : 0, stream.fill()
+  );
+  const char* sign = negative ? "-" : "";
+
+  const std::ios_base::fmtflags adjust =
+      stream.flags() & std::ios_base::adjustfield;
+  if (adjust == std::ios_base::left) {
+    return stream << sign << digits << fill;
+  }
+  if (adjust == std::ios_base::internal) {
+    return stream << sign << fill << digits;
+  }
+  return stream << fill << sign << digits;
+}
+
+} // namespace int128
+
+// Standard streams can't print 128-bit integers
+inline std::ostream& operator<<(std::ostream& stream, uint128_t value) {
+  return int128::print(stream, false, int128::to_string(value));
+}
+
+inline std::ostream& operator<<(std::ostream& stream, int128_t value) {
+  uint128_t abs_value(value);
+  if (value < 0) {
+    abs_value = 0 - abs_value;
+  }
+  return int128::print(stream, value < 0, int128::to_string(abs_value));
+}
+
+#endif // HAVE_INT128
+
+// Unsigned type of 64 or 128 bits which can hold any `Unsigned` value,
+// used to select overloads without ambiguous integral conversions
+template <class Unsigned>
+class WideUnsigned {
+ public:
+#if HAVE_INT128
+  using type = typename std::conditional<
+      (sizeof(Unsigned) > sizeof(uint64_t)), uint128_t, uint64_t
+  >::type;
+#else
+  using type = uint64_t;
+#endif
+};
+
+#endif // INT128_HPP_
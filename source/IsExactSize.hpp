@@ -0,0 +1,16 @@
+#ifndef IS_EXACT_SIZE_HPP_
+#define IS_EXACT_SIZE_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+// Does `Algo` size its own output (by default: no). Specialized in Algos.hpp,
+// Runner converts by `Algo::generate` into buffer of exactly text size + '\0'
+// instead of `Output` (`Input::bytes_per_value` per value).
+template <class Algo>
+class IsExactSize {
+ public:
+  static const bool value = false;
+};
+
+#endif // IS_EXACT_SIZE_HPP_
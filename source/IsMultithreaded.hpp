@@ -0,0 +1,16 @@
+#ifndef IS_MULTITHREADED_HPP_
+#define IS_MULTITHREADED_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+// Does `Algo` start threads (by default: no). Specialized in Algos.hpp,
+// Runner restores original thread affinity while such algorithm runs
+// (new threads inherit affinity of the main thread, see Benchmark.hpp).
+template <class Algo>
+class IsMultithreaded {
+ public:
+  static const bool value = false;
+};
+
+#endif // IS_MULTITHREADED_HPP_
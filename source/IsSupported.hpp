@@ -0,0 +1,16 @@
+#ifndef IS_SUPPORTED_HPP_
+#define IS_SUPPORTED_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+// Can `Algo` convert values of `Integer` type (by default: yes).
+// Specialized in Algos.hpp for libraries without 128-bit support,
+// Runner doesn't instantiate algorithm for unsupported types.
+template <class Algo, class Integer>
+class IsSupported {
+ public:
+  static const bool value = true;
+};
+
+#endif // IS_SUPPORTED_HPP_
@@ -0,0 +1,142 @@
+#ifndef OPTIONS_HPP_
+#define OPTIONS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::find
+#include <cstddef> // size_t
+#include <map>
+#include <sstream> // std::istringstream
+#include <stdexcept> // std::runtime_error
+#include <string>
+#include <vector>
+
+// Command line: `--name=value1,value2,...` (list) or `--name` (switch).
+// Option not set: every value selected.
+class Options {
+ public:
+  Options(int argc, char** argv) {
+    const std::vector<std::string> lists{
+        "type",
+        "algo",
+        "size",
+        "digit",
+        "sign",
+        "same-size",
+        "separator",
+        "distribution",
+        "operation"
+    };
+    const std::vector<std::string> switches{"list", "help"};
+
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg(argv[i]);
+      if (arg.compare(0, 2, "--") != 0) {
+        throw std::runtime_error("Unexpected argument: " + arg);
+      }
+      const size_t equal = arg.find('=');
+      const std::string name = arg.substr(2, equal - 2);
+      if (equal == std::string::npos) {
+        if (!contains(switches, name)) {
+          throw std::runtime_error("Unknown option: " + arg);
+        }
+        options_[name];
+        continue;
+      }
+      if (!contains(lists, name)) {
+        throw std::runtime_error("Unknown option: " + arg);
+      }
+      std::vector<std::string>& values = options_[name];
+      std::istringstream stream(arg.substr(equal + 1));
+      std::string value;
+      while (std::getline(stream, value, ',')) {
+        values.push_back(value);
+      }
+      if (values.empty()) {
+        throw std::runtime_error("Empty list: " + arg);
+      }
+    }
+  }
+
+  bool is_set(const std::string& name) const {
+    return options_.find(name) != options_.end();
+  }
+
+  // Option not set or `value` in list
+  bool selected(const std::string& name, const std::string& value) const {
+    auto it = options_.find(name);
+    return it == options_.end() || contains(it->second, value);
+  }
+
+  // Every value of the list is one of the `known` (e.g. no typo in name)
+  void check(
+      const std::string& name, const std::vector<std::string>& known
+  ) const {
+    auto it = options_.find(name);
+    if (it == options_.end()) {
+      return;
+    }
+    for (auto& i: it->second) {
+      if (!contains(known, i)) {
+        throw std::runtime_error("Unknown value of --" + name + ": " + i);
+      }
+    }
+  }
+
+  // Values of the list, `defaults` if not set
+  std::vector<std::string> values(
+      const std::string& name, const std::vector<std::string>& defaults
+  ) const {
+    auto it = options_.find(name);
+    return (it == options_.end()) ? defaults : it->second;
+  }
+
+  // Non-negative integers of the list, `defaults` if not set
+  template <class T>
+  std::vector<T> numbers(
+      const std::string& name, const std::vector<T>& defaults
+  ) const {
+    auto it = options_.find(name);
+    if (it == options_.end()) {
+      return defaults;
+    }
+    std::vector<T> result;
+    for (auto& i: it->second) {
+      if (i.empty() || i.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::runtime_error("Not a number in --" + name + ": " + i);
+      }
+      result.push_back(static_cast<T>(std::stoull(i)));
+    }
+    return result;
+  }
+
+  // Values `on`/`off` of the list, `defaults` if not set
+  std::vector<bool> flags(
+      const std::string& name, const std::vector<bool>& defaults
+  ) const {
+    auto it = options_.find(name);
+    if (it == options_.end()) {
+      return defaults;
+    }
+    std::vector<bool> result;
+    for (auto& i: it->second) {
+      if (i != "on" && i != "off") {
+        throw std::runtime_error("Expected on/off in --" + name + ": " + i);
+      }
+      result.push_back(i == "on");
+    }
+    return result;
+  }
+
+ private:
+  static bool contains(
+      const std::vector<std::string>& list, const std::string& value
+  ) {
+    return std::find(list.begin(), list.end(), value) != list.end();
+  }
+
+  std::map<std::string, std::vector<std::string>> options_;
+};
+
+#endif // OPTIONS_HPP_
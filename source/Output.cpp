@@ -5,9 +5,9 @@
 
 #include "Output.ipp"
 
-void Output::use_buffer(const char* name) {
+void Output::use_buffer(const char* data, const char* name) {
 #if !defined(NDEBUG)
-  std::string temp(buffer());
+  std::string temp(data);
   if (temp != check_result_) {
     std::cerr << "expected: " << check_result_ << std::endl;
     std::cerr << "got: " << temp << std::endl;
@@ -7,10 +7,13 @@
 #include <vector>
 #include <string>
 
+#include "Format.hpp"
+
 class Output {
  public:
-  template <class Input>
-  Output(size_t size, const Input& input);
+  // `Format` - expected format of values (see Format.hpp)
+  template <class Input, class Format = format::Plain>
+  Output(size_t size, const Input& input, Format = Format());
   ~Output() = default;
 
   Output(const Output&) = delete;
@@ -33,7 +36,12 @@ class Output {
     return buffer_.size();
   }
 
-  void use_buffer(const char* name);
+  void use_buffer(const char* name) {
+    use_buffer(buffer(), name);
+  }
+
+  // Result of algorithm in its own buffer (see IsExactSize.hpp)
+  void use_buffer(const char* data, const char* name);
 
  private:
 #if !defined(NDEBUG)
@@ -10,14 +10,21 @@
 #include <cassert>
 #include <sstream> // std::ostringstream
 
-template <class Input>
-Output::Output(size_t size, const Input& input) {
+template <class Input, class Format>
+Output::Output(size_t size, const Input& input, Format) {
   assert(size > 0);
   buffer_.resize(size);
 #if !defined(NDEBUG)
+  using Separator = typename Input::separator_t;
+
   std::ostringstream stream;
+  bool first = true;
   for (auto i: input.values()) {
-    stream << i;
+    if (!first) {
+      stream << Separator::str();
+    }
+    first = false;
+    Format::write(stream, i);
   }
   check_result_ = stream.str();
   assert(!check_result_.empty());
@@ -0,0 +1,135 @@
+#ifndef PARSE_RUNNER_HPP_
+#define PARSE_RUNNER_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert>
+#include <limits> // std::numeric_limits
+#include <stdexcept> // std::runtime_error
+#include <type_traits> // std::integral_constant
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "IsSupported.hpp"
+#include "counting.hpp"
+
+// Parsing counterpart of Runner: text [begin, end) with values of `Input`
+// separated by `Input::separator_t` (produced by formatter) parsed back.
+// Every sample ends with round trip check: parsed values must be equal
+// to `Input::values()`.
+template <class Input, class Parser>
+class ParseRunner: public benchmark::SampledTask {
+ public:
+  static const bool enabled = Parser::enabled &&
+      IsSupported<Parser, typename Input::value_t>::value;
+
+  static_assert(
+      Input::separator_t::size != 0, "Values without separator can't be parsed"
+  );
+
+  ParseRunner(
+      const Input& input, const char* begin, const char* end, const char* name
+  ):
+      benchmark::SampledTask(name),
+      input_(input),
+      begin_(begin),
+      end_(end),
+      values_(input.size())
+  {
+#if !defined(NDEBUG)
+    if (enabled) {
+      test_parser();
+    }
+#endif
+  }
+
+  // One sample, first call: warm-up and calibration
+  void run() override {
+    if (!enabled) {
+      return;
+    }
+
+    sample([this]() {
+      run_parser(begin_, end_, values_);
+
+      // prevent compiler optimization
+      benchmark::escape(values_.data());
+    });
+
+    if (values_ != input_.values()) {
+      throw std::runtime_error(std::string("Round trip failed: ") + name());
+    }
+  }
+
+ private:
+  using value_t = typename Input::value_t;
+  using separator_t = typename Input::separator_t;
+  using Vector = typename Input::Vector;
+  using Supported = std::integral_constant<bool, enabled>;
+
+  static void run_parser(const char* begin, const char* end, Vector& out) {
+    run_parser(begin, end, out, Supported());
+  }
+
+  static void run_parser(
+      const char* begin, const char* end, Vector& out, std::true_type
+  ) {
+    Parser::template run<separator_t>(begin, end, out);
+  }
+
+  static void run_parser(const char*, const char*, Vector&, std::false_type) {
+    throw std::runtime_error("Parser is not supported");
+  }
+
+  // Round trip of boundary values (formatted by `counting`)
+  void test_parser() {
+    test_parser_iteration(0);
+    test_parser_iteration(-10);
+    test_parser_iteration(10);
+    test_parser_iteration(std::numeric_limits<value_t>::max());
+    test_parser_iteration(std::numeric_limits<value_t>::min());
+    test_parser_iteration(std::numeric_limits<value_t>::max() - 1);
+    test_parser_iteration(std::numeric_limits<value_t>::min() + 1);
+    test_parser_iteration(std::numeric_limits<value_t>::max() / 2);
+    test_parser_iteration(std::numeric_limits<value_t>::min() / 2);
+
+    test_parser_iteration(5248118ll);
+    test_parser_iteration(-5248118ll);
+    test_parser_iteration(-848ll);
+  }
+
+  template <class T>
+  void test_parser_iteration(T input_value) {
+    const value_t value(static_cast<value_t>(input_value));
+
+    // 1..17 values: different alignment of the last value to `end`
+    for (size_t size = 1; size < 18; ++size) {
+      const Vector expected(size, value);
+
+      std::vector<char> text(expected.size() * Input::bytes_per_value);
+      char* sink = text.data();
+      for (auto& i: expected) {
+        counting::generate(sink, i);
+        separator_t::write(sink);
+      }
+      sink -= separator_t::size;
+
+      Vector result(expected.size());
+      run_parser(text.data(), sink, result);
+
+      if (result != expected) {
+        std::cerr << "Parse " << value << " failed for " << name();
+        std::cerr << " (separator: " << separator_t::name() << ")" << std::endl;
+        throw std::runtime_error("Incorrect parser");
+      }
+    }
+  }
+
+  const Input& input_;
+  const char* begin_;
+  const char* end_;
+  Vector values_;
+};
+
+#endif // PARSE_RUNNER_HPP_
@@ -0,0 +1,100 @@
+#ifndef PARSERS_HPP_
+#define PARSERS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include "Int128.hpp"
+#include "IsSupported.hpp"
+#include "parse_strtoll.hpp"
+#include "parse_scalar.hpp"
+#include "parse_swar.hpp"
+#include "parse_simd.hpp"
+
+// Parse `out.size()` values from text [buffer, end),
+// values separated by `Separator` (see ParseRunner.hpp)
+
+class ParserStrtoll {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "strtoll";
+  }
+
+  template <class Separator, class Vector>
+  static void run(const char* buffer, const char*, Vector& out) {
+    using Integer = typename Vector::value_type;
+    for (auto& i: out) {
+      i = parse_strtoll::parse<Integer>(buffer);
+      buffer += Separator::size;
+    }
+  }
+};
+
+#if HAVE_INT128
+// No 128-bit `strtoll`
+template <>
+class IsSupported<ParserStrtoll, int128_t> {
+ public:
+  static const bool value = false;
+};
+
+template <>
+class IsSupported<ParserStrtoll, uint128_t> {
+ public:
+  static const bool value = false;
+};
+#endif
+
+class ParserScalar {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "parse_scalar";
+  }
+
+  template <class Separator, class Vector>
+  static void run(const char* buffer, const char*, Vector& out) {
+    using Integer = typename Vector::value_type;
+    for (auto& i: out) {
+      i = parse_scalar::parse<Integer>(buffer);
+      buffer += Separator::size;
+    }
+  }
+};
+
+class ParserSwar {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "parse_swar";
+  }
+
+  template <class Separator, class Vector>
+  static void run(const char* buffer, const char* end, Vector& out) {
+    using Integer = typename Vector::value_type;
+    for (auto& i: out) {
+      i = parse_swar::parse<Integer>(buffer, end);
+      buffer += Separator::size;
+    }
+  }
+};
+
+class ParserSimd {
+ public:
+  static const bool enabled = true;
+
+  static const char* name() {
+    return "parse_simd";
+  }
+
+  template <class Separator, class Vector>
+  static void run(const char* buffer, const char* end, Vector& out) {
+    parse_simd::parse<Separator>(buffer, end, out);
+  }
+};
+
+#endif // PARSERS_HPP_
@@ -0,0 +1,246 @@
+#ifndef PERF_COUNTERS_HPP_
+#define PERF_COUNTERS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <array>
+#include <cstdint> // uint64_t
+#include <cstdlib> // std::getenv
+#include <cstring> // std::strerror
+#include <iostream> // std::cout
+#include <string>
+
+#if defined(__linux__)
+# include <cerrno> // errno
+# include <linux/perf_event.h> // perf_event_attr
+# include <sys/ioctl.h> // ioctl
+# include <sys/syscall.h> // __NR_perf_event_open
+# include <unistd.h> // syscall
+#endif
+
+// Hardware performance counters of the calling thread and threads it
+// creates after counters are opened (user space only), Linux
+// `perf_event_open`. Threads created before (e.g. persistent pool) are
+// not counted. Enabled by environment variable INT_DEC_PERF
+// (any value). Counters which can't be opened (no PMU in container/VM,
+// perf_event_paranoid, not Linux) are reported as not available, one
+// message per run.
+namespace perf {
+
+enum Event {
+  CYCLES,
+  INSTRUCTIONS,
+  BRANCH_MISSES,
+  L1D_MISSES,
+  LLC_MISSES,
+  EVENTS_NUMBER
+};
+
+inline const char* event_name(int event) {
+  static const char* names[EVENTS_NUMBER] = {
+      "cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses"
+  };
+  return names[event];
+}
+
+// Totals of all `start`/`stop` intervals, negative: not available
+class Values {
+ public:
+  Values() {
+    values_.fill(-1);
+  }
+
+  double operator[](int event) const {
+    return values_[event];
+  }
+
+  double& operator[](int event) {
+    return values_[event];
+  }
+
+  bool available(int event) const {
+    return values_[event] >= 0;
+  }
+
+  bool any() const {
+    for (auto i: values_) {
+      if (i >= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::array<double, EVENTS_NUMBER> values_;
+};
+
+inline bool enabled() {
+  static const bool result = (std::getenv("INT_DEC_PERF") != nullptr);
+  return result;
+}
+
+class Counters {
+ public:
+  Counters() {
+    fds_.fill(-1);
+    if (!enabled()) {
+      return;
+    }
+#if defined(__linux__)
+    for (int i = 0; i < EVENTS_NUMBER; ++i) {
+      fds_[i] = open(i);
+      if (fds_[i] >= 0) {
+        totals_[i] = 0;
+      }
+    }
+#endif
+    report_once(totals_);
+  }
+
+  ~Counters() {
+#if defined(__linux__)
+    for (auto fd: fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+#endif
+  }
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  void start() {
+#if defined(__linux__)
+    for (auto fd: fds_) {
+      if (fd >= 0) {
+        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  void stop() {
+#if defined(__linux__)
+    for (auto fd: fds_) {
+      if (fd >= 0) {
+        ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+    for (int i = 0; i < EVENTS_NUMBER; ++i) {
+      if (fds_[i] >= 0) {
+        totals_[i] += read(fds_[i]);
+      }
+    }
+#endif
+  }
+
+  const Values& totals() const {
+    return totals_;
+  }
+
+ private:
+#if defined(__linux__)
+  // Event of the calling thread and its new threads (inherited), user
+  // space only. Returns -1 on fail.
+  static int open(int event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.inherit = 1; // read/ioctl of `fd` include child threads
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const uint64_t cache_miss =
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    switch (event) {
+      case CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case BRANCH_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+      case L1D_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | cache_miss;
+        break;
+      case LLC_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL | cache_miss;
+        break;
+    }
+
+    const long fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+      error() = std::strerror(errno);
+    }
+    return static_cast<int>(fd);
+  }
+
+  // Value scaled by enabled/running time (counters multiplexed)
+  static double read(int fd) {
+    uint64_t data[3] = {0, 0, 0}; // value, time enabled, time running
+    if (::read(fd, data, sizeof(data)) != sizeof(data) || data[2] == 0) {
+      return 0;
+    }
+    const double value = static_cast<double>(data[0]);
+    if (data[2] < data[1]) {
+      return value * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+    }
+    return value;
+  }
+#endif
+
+  // Reason of the last `open` fail
+  static std::string& error() {
+    static std::string result;
+    return result;
+  }
+
+  // First counters of the run: print what is available
+  static void report_once(const Values& values) {
+    static bool reported = false;
+    if (reported) {
+      return;
+    }
+    reported = true;
+    std::string available;
+    std::string not_available;
+    for (int i = 0; i < EVENTS_NUMBER; ++i) {
+      std::string& list = values.available(i) ? available : not_available;
+      list += " ";
+      list += event_name(i);
+    }
+    std::cout << "Performance counters:";
+    std::cout << (available.empty() ? " none" : available);
+    if (!not_available.empty()) {
+      std::cout << " (not available:" << not_available;
+      if (!error().empty()) {
+        std::cout << ", " << error();
+      }
+      std::cout << ")";
+    }
+    std::cout << std::endl;
+  }
+
+  std::array<int, EVENTS_NUMBER> fds_;
+  Values totals_;
+};
+
+} // namespace perf
+
+#endif // PERF_COUNTERS_HPP_
@@ -0,0 +1,242 @@
+#ifndef PIPELINE_HPP_
+#define PIPELINE_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::min
+#include <atomic>
+#include <cstdint> // uint64_t
+#include <limits> // std::numeric_limits
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FdSink.hpp" // FdSink::write_all
+#include "Separator.hpp"
+#include "SpscRing.hpp"
+#include "Timer.hpp"
+
+// Three threads connected by lock-free rings of chunks:
+//   generate: values of input (replayed in a loop) copied to value chunks
+//   format: value chunk converted to text chunk by `Algo::run`
+//   write: text chunk written to file descriptor
+// Stall - time stage waits for the next stage (ring is full) or for the
+// previous one (ring is empty). Stage with least stall time is the
+// bottleneck.
+namespace pipeline {
+
+using Duration = Timer::Duration;
+
+template <class Integer>
+class ValueChunk {
+ public:
+  std::vector<Integer> values;
+  bool last; // end of stream, no values
+};
+
+class TextChunk {
+ public:
+  std::vector<char> data;
+  size_t size;
+  bool last; // end of stream, no data
+};
+
+class Stage {
+ public:
+  Stage(): input_stall(Duration::zero()), output_stall(Duration::zero()) {
+  }
+
+  Duration input_stall; // previous stage too slow
+  Duration output_stall; // next stage too slow
+};
+
+class Result {
+ public:
+  Result(): total(Duration::zero()), bytes(0) {
+  }
+
+  Duration total;
+  uint64_t bytes;
+  Stage generate;
+  Stage format;
+  Stage write;
+};
+
+// Wait for non-null `get()`, time of waiting added to `stall`
+template <class Get>
+auto wait(Get get, Duration& stall) -> decltype(get()) {
+  auto result = get();
+  if (result != nullptr) {
+    return result;
+  }
+  const Timer::TimePoint start = Timer::now();
+  while ((result = get()) == nullptr) {
+    std::this_thread::yield();
+  }
+  stall += Timer::now() - start;
+  return result;
+}
+
+// `count` values of `in` (repeated) formatted by `Algo` and written to
+// `fd`, `Separator` after every value. If `copy` is not null, all text
+// appended to it.
+template <class Algo, class Separator, class Vector>
+Result run(
+    const Vector& in,
+    uint64_t count,
+    int fd,
+    size_t chunk_values,
+    size_t ring_capacity,
+    std::string* copy
+) {
+  using Integer = typename Vector::value_type;
+  using Values = ValueChunk<Integer>;
+
+  static const size_t max_size =
+      std::numeric_limits<Integer>::digits10 +
+      1 + // rounding error
+      1 + // sign
+      Separator::size;
+
+  Values values_slot;
+  values_slot.values.reserve(chunk_values);
+  values_slot.last = false;
+
+  TextChunk text_slot;
+  text_slot.data.resize(chunk_values * max_size + 1); // terminating '\0'
+  text_slot.size = 0;
+  text_slot.last = false;
+
+  SpscRing<Values> values_ring(ring_capacity, values_slot);
+  SpscRing<TextChunk> text_ring(ring_capacity, text_slot);
+
+  Result result;
+
+  // next stages failed: generate stage ends the stream early
+  std::atomic<bool> cancel(false);
+
+  auto generate = [&]() {
+    size_t next = 0;
+    for (uint64_t left = count;
+        left != 0 && !cancel.load(std::memory_order_relaxed);) {
+      Values* chunk = wait(
+          [&]() { return values_ring.back(); }, result.generate.output_stall
+      );
+      const size_t size = static_cast<size_t>(
+          std::min<uint64_t>(left, chunk_values)
+      );
+      chunk->values.resize(size);
+      for (size_t i = 0; i < size; ++i) {
+        chunk->values[i] = in[next];
+        next = (next + 1 == in.size()) ? 0 : next + 1;
+      }
+      chunk->last = false;
+      values_ring.push();
+      left -= size;
+    }
+    Values* chunk = wait(
+        [&]() { return values_ring.back(); }, result.generate.output_stall
+    );
+    chunk->values.clear();
+    chunk->last = true;
+    values_ring.push();
+  };
+
+  auto format = [&]() {
+    while (true) {
+      const Values* chunk = wait(
+          [&]() { return values_ring.front(); }, result.format.input_stall
+      );
+      TextChunk* text = wait(
+          [&]() { return text_ring.back(); }, result.format.output_stall
+      );
+      text->last = chunk->last;
+      text->size = 0;
+      if (!chunk->last) {
+        // separator after the last value removed by `run`
+        char* data = text->data.data();
+        char* end = Algo::template run<Separator>(data, chunk->values);
+        Separator::write(end);
+        text->size = static_cast<size_t>(end - data);
+      }
+      const bool last = chunk->last;
+      values_ring.pop();
+      text_ring.push();
+      if (last) {
+        return;
+      }
+    }
+  };
+
+  const Timer::TimePoint start = Timer::now();
+
+  std::thread generate_thread(generate);
+  std::thread format_thread;
+  try {
+    format_thread = std::thread(format);
+  }
+  catch (...) {
+    // no consumer of value chunks: drained here, started stage joined
+    // (no `std::terminate` by `std::thread`)
+    cancel.store(true, std::memory_order_relaxed);
+    while (true) {
+      const Values* chunk = wait(
+          [&]() { return values_ring.front(); }, result.format.input_stall
+      );
+      const bool last = chunk->last;
+      values_ring.pop();
+      if (last) {
+        break;
+      }
+    }
+    generate_thread.join();
+    throw;
+  }
+
+  // write stage: current thread
+  try {
+    while (true) {
+      const TextChunk* text = wait(
+          [&]() { return text_ring.front(); }, result.write.input_stall
+      );
+      if (text->last) {
+        text_ring.pop();
+        break;
+      }
+      FdSink::write_all(fd, text->data.data(), text->size);
+      result.bytes += text->size;
+      if (copy != nullptr) {
+        copy->append(text->data.data(), text->size);
+      }
+      text_ring.pop();
+    }
+  }
+  catch (...) {
+    // drain: other stages never block forever on full ring
+    cancel.store(true, std::memory_order_relaxed);
+    while (true) {
+      const TextChunk* text = wait(
+          [&]() { return text_ring.front(); }, result.write.input_stall
+      );
+      const bool last = text->last;
+      text_ring.pop();
+      if (last) {
+        break;
+      }
+    }
+    generate_thread.join();
+    format_thread.join();
+    throw;
+  }
+
+  generate_thread.join();
+  format_thread.join();
+
+  result.total = Timer::now() - start;
+  return result;
+}
+
+} // namespace pipeline
+
+#endif // PIPELINE_HPP_
@@ -0,0 +1,112 @@
+#ifndef REGISTRY_HPP_
+#define REGISTRY_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include "Algos.hpp"
+#include "Columns.hpp"
+#include "DigitCounters.hpp"
+#include "Dispatch.hpp"
+#include "Format.hpp"
+#include "Int128.hpp"
+#include "Parsers.hpp"
+
+// Compile-time lists of tested types and algorithms. New algorithm:
+// class with `enabled`, `name()` and `run` (see Algos.hpp) added to
+// `Formatters` (or `Parsers`), runners are created by main.cpp.
+// Digit counters: `name()` and `count` (see DigitCounters.hpp),
+// string columns: `name()` and `run` (see Columns.hpp).
+namespace registry {
+
+template <class... Items>
+class List {
+};
+
+// Call `functor(Item())` for every item of the list, in order
+template <class... Items, class Functor>
+void for_each(List<Items...>, Functor& functor) {
+  const int unused[] = {0, (functor(Items()), 0)...};
+  static_cast<void>(unused);
+}
+
+// Formatting algorithm and expected format of its output (see Format.hpp)
+template <class Algo, class Format = format::Plain>
+class Formatter {
+ public:
+  using algo_t = Algo;
+  using format_t = Format;
+
+  static const char* name() {
+    return Algo::name();
+  }
+};
+
+using Types = List<
+    short,
+    int,
+    long,
+    long long,
+    unsigned short,
+    unsigned int,
+    unsigned long,
+    unsigned long long
+#if HAVE_INT128
+    ,
+    int128_t,
+    uint128_t
+#endif
+>;
+
+using Formatters = List<
+    Formatter<AlgoFmtFormat>,
+    Formatter<AlgoBoostKarma>,
+    Formatter<AlgoAlexandrescu>,
+    Formatter<AlgoAlexandrescuLzcnt>,
+    Formatter<AlgoReverse>,
+    Formatter<AlgoTmpbuf>,
+    Formatter<AlgoCounting>,
+    Formatter<AlgoCountingLzcnt>,
+    Formatter<AlgoSimd>,
+    Formatter<AlgoTwoPass>,
+    Formatter<AlgoParallel>,
+    Formatter<AlgoReciprocal>,
+    Formatter<AlgoPaddedZero, format::Padded<'0'>>,
+    Formatter<AlgoPaddedSpace, format::Padded<' '>>,
+    Formatter<AlgoPaddedZero6, format::Padded<'0', 6>>,
+    Formatter<AlgoFixedCents, format::Fixed<2>>,
+    Formatter<AlgoFixedMicro, format::Fixed<6>>,
+    Formatter<AlgoFixedRuntime, format::Fixed<6>>,
+    Formatter<AlgoHex, format::Radix<16>>,
+    Formatter<AlgoHexUpper, format::Radix<16, true>>,
+    Formatter<AlgoHexSimd, format::Radix<16>>,
+    Formatter<AlgoOctal, format::Radix<8>>,
+    Formatter<AlgoOctalSimd, format::Radix<8>>,
+    Formatter<AlgoSwar>,
+    Formatter<AlgoIncremental>,
+    Formatter<AlgoBucketed>,
+    Formatter<AlgoDispatch>
+>;
+
+using Parsers = List<
+    ParserStrtoll,
+    ParserScalar,
+    ParserSwar,
+    ParserSimd
+>;
+
+using Counters = List<
+    CounterBisection,
+    CounterTree,
+    CounterLzcnt
+>;
+
+using Columns = List<
+    ColumnInt32,
+    ColumnInt64,
+    ColumnToString
+>;
+
+} // namespace registry
+
+#endif // REGISTRY_HPP_
@@ -0,0 +1,592 @@
+#ifndef RESULTS_HPP_
+#define RESULTS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cctype> // std::isspace
+#include <cmath> // std::pow, std::log10
+#include <cstdlib> // std::getenv
+#include <fstream> // std::ofstream
+#include <iomanip> // std::setprecision
+#include <iterator> // std::istreambuf_iterator
+#include <map>
+#include <sstream> // std::istringstream
+#include <stdexcept> // std::runtime_error
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+// Machine-readable results: one record per algorithm and input
+// configuration. Written to file from environment variable
+// INT_DEC_RESULTS (extension ".csv": CSV, otherwise JSON), read back by
+// `int_dec_compare` (see compare.cpp).
+namespace results {
+
+// Input configuration of one test
+class Config {
+ public:
+  std::string operation; // "format", "parse", "count", "column"
+  std::string type; // "long long"
+  std::string separator; // "none", "','"
+  int digit; // 0: any number of digits
+  bool sign;
+  bool same_size;
+  std::string distribution; // "uniform", "zipf:1.1" (see Distribution.hpp)
+  size_t buffer; // bytes
+  size_t values;
+};
+
+// Times in nanoseconds, per iteration (all `values` converted).
+// Performance counters per value, negative: not available.
+class Record {
+ public:
+  Record():
+      digit(0),
+      sign(false),
+      same_size(false),
+      distribution("uniform"),
+      buffer(0),
+      values(0),
+      median_ns(0),
+      ci_low_ns(0),
+      ci_high_ns(0),
+      p10_ns(0),
+      p90_ns(0),
+      mad_ns(0),
+      ns_per_value(0),
+      samples(0),
+      outliers(0),
+      iterations(0),
+      cycles(-1),
+      instructions(-1),
+      ipc(-1),
+      branch_misses(-1),
+      l1d_misses(-1),
+      llc_misses(-1) {
+  }
+
+  Record(const Config& config, const std::string& algo_name):
+      operation(config.operation),
+      type(config.type),
+      separator(config.separator),
+      digit(config.digit),
+      sign(config.sign),
+      same_size(config.same_size),
+      distribution(config.distribution),
+      buffer(config.buffer),
+      values(config.values),
+      algo(algo_name),
+      median_ns(0),
+      ci_low_ns(0),
+      ci_high_ns(0),
+      p10_ns(0),
+      p90_ns(0),
+      mad_ns(0),
+      ns_per_value(0),
+      samples(0),
+      outliers(0),
+      iterations(0),
+      cycles(-1),
+      instructions(-1),
+      ipc(-1),
+      branch_misses(-1),
+      l1d_misses(-1),
+      llc_misses(-1) {
+  }
+
+  std::string operation;
+  std::string type;
+  std::string separator;
+  int digit;
+  bool sign;
+  bool same_size;
+  std::string distribution;
+  size_t buffer;
+  size_t values;
+  std::string algo;
+  double median_ns;
+  double ci_low_ns;
+  double ci_high_ns;
+  double p10_ns;
+  double p90_ns;
+  double mad_ns;
+  double ns_per_value;
+  size_t samples;
+  size_t outliers;
+  int iterations;
+  double cycles;
+  double instructions;
+  double ipc;
+  double branch_misses;
+  double l1d_misses;
+  double llc_misses;
+};
+
+using Records = std::vector<Record>;
+
+// Same input configuration and algorithm
+inline std::string key(const Record& record) {
+  std::ostringstream result;
+  result << record.operation << " " << record.type;
+  result << " separator:" << record.separator;
+  result << " digit:" << record.digit;
+  result << " sign:" << record.sign;
+  result << " same_size:" << record.same_size;
+  // uniform: same keys as results without distribution
+  if (record.distribution != "uniform") {
+    result << " distribution:" << record.distribution;
+  }
+  result << " buffer:" << record.buffer;
+  result << " " << record.algo;
+  return result.str();
+}
+
+// Fields in output order, values as text
+inline std::vector<std::pair<std::string, std::string>> fields(
+    const Record& record
+) {
+  auto number = [](double value) {
+    std::ostringstream result;
+    result << std::setprecision(10) << value;
+    return result.str();
+  };
+
+  return {
+      {"operation", record.operation},
+      {"type", record.type},
+      {"separator", record.separator},
+      {"digit", std::to_string(record.digit)},
+      {"sign", std::to_string(record.sign)},
+      {"same_size", std::to_string(record.same_size)},
+      {"distribution", record.distribution},
+      {"buffer", std::to_string(record.buffer)},
+      {"values", std::to_string(record.values)},
+      {"algo", record.algo},
+      {"median_ns", number(record.median_ns)},
+      {"ci_low_ns", number(record.ci_low_ns)},
+      {"ci_high_ns", number(record.ci_high_ns)},
+      {"p10_ns", number(record.p10_ns)},
+      {"p90_ns", number(record.p90_ns)},
+      {"mad_ns", number(record.mad_ns)},
+      {"ns_per_value", number(record.ns_per_value)},
+      {"samples", std::to_string(record.samples)},
+      {"outliers", std::to_string(record.outliers)},
+      {"iterations", std::to_string(record.iterations)},
+      {"cycles", number(record.cycles)},
+      {"instructions", number(record.instructions)},
+      {"ipc", number(record.ipc)},
+      {"branch_misses", number(record.branch_misses)},
+      {"l1d_misses", number(record.l1d_misses)},
+      {"llc_misses", number(record.llc_misses)}
+  };
+}
+
+// Inverse of `fields`, unknown names ignored
+inline Record from_fields(const std::map<std::string, std::string>& values) {
+  auto text = [&values](const char* name) {
+    auto it = values.find(name);
+    return (it == values.end()) ? std::string() : it->second;
+  };
+  auto number = [&text](const char* name) {
+    const std::string value = text(name);
+    return value.empty() ? 0.0 : std::stod(value);
+  };
+  auto counter = [&text](const char* name) {
+    const std::string value = text(name);
+    return value.empty() ? -1.0 : std::stod(value);
+  };
+
+  Record record;
+  record.operation = text("operation");
+  record.type = text("type");
+  record.separator = text("separator");
+  record.digit = static_cast<int>(number("digit"));
+  record.sign = (number("sign") != 0);
+  record.same_size = (number("same_size") != 0);
+  if (!text("distribution").empty()) {
+    record.distribution = text("distribution");
+  }
+  record.buffer = static_cast<size_t>(number("buffer"));
+  record.values = static_cast<size_t>(number("values"));
+  record.algo = text("algo");
+  record.median_ns = number("median_ns");
+  record.ci_low_ns = number("ci_low_ns");
+  record.ci_high_ns = number("ci_high_ns");
+  record.p10_ns = number("p10_ns");
+  record.p90_ns = number("p90_ns");
+  record.mad_ns = number("mad_ns");
+  record.ns_per_value = number("ns_per_value");
+  record.samples = static_cast<size_t>(number("samples"));
+  record.outliers = static_cast<size_t>(number("outliers"));
+  record.iterations = static_cast<int>(number("iterations"));
+  record.cycles = counter("cycles");
+  record.instructions = counter("instructions");
+  record.ipc = counter("ipc");
+  record.branch_misses = counter("branch_misses");
+  record.l1d_misses = counter("l1d_misses");
+  record.llc_misses = counter("llc_misses");
+  return record;
+}
+
+inline bool is_number(const std::string& name) {
+  return name != "operation" && name != "type" &&
+      name != "separator" && name != "distribution" && name != "algo";
+}
+
+inline std::string csv_quote(const std::string& value) {
+  std::string result("\"");
+  for (char c: value) {
+    if (c == '"') {
+      result += '"';
+    }
+    result += c;
+  }
+  result += '"';
+  return result;
+}
+
+inline std::string json_quote(const std::string& value) {
+  std::string result("\"");
+  for (char c: value) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  result += '"';
+  return result;
+}
+
+// Records written as soon as added, file closed at exit
+class Writer {
+ public:
+  explicit Writer(const std::string& path):
+      csv_(is_csv(path)),
+      count_(0) {
+    if (path.empty()) {
+      return;
+    }
+    file_.open(path);
+    if (!file_) {
+      throw std::runtime_error("Can't open results file: " + path);
+    }
+    if (csv_) {
+      bool first = true;
+      for (auto& i: fields(Record())) {
+        file_ << (first ? "" : ",") << i.first;
+        first = false;
+      }
+      file_ << "\n";
+    }
+    else {
+      file_ << "[";
+    }
+  }
+
+  ~Writer() {
+    if (file_.is_open() && !csv_) {
+      file_ << (count_ == 0 ? "]\n" : "\n]\n");
+    }
+  }
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  bool enabled() const {
+    return file_.is_open();
+  }
+
+  void add(const Record& record) {
+    if (!enabled()) {
+      return;
+    }
+
+    bool first = true;
+    if (csv_) {
+      for (auto& i: fields(record)) {
+        file_ << (first ? "" : ",");
+        file_ << (is_number(i.first) ? i.second : csv_quote(i.second));
+        first = false;
+      }
+      file_ << "\n";
+    }
+    else {
+      file_ << (count_ == 0 ? "\n  {" : ",\n  {");
+      for (auto& i: fields(record)) {
+        file_ << (first ? "" : ", ") << json_quote(i.first) << ": ";
+        file_ << (is_number(i.first) ? i.second : json_quote(i.second));
+        first = false;
+      }
+      file_ << "}";
+    }
+    file_.flush();
+    ++count_;
+  }
+
+  static bool is_csv(const std::string& path) {
+    const std::string extension(".csv");
+    return path.size() >= extension.size() &&
+        path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+  }
+
+ private:
+  const bool csv_;
+  size_t count_;
+  std::ofstream file_;
+};
+
+// Writer created on first use (variable not set: nothing written)
+inline Writer& writer() {
+  static const char* path = std::getenv("INT_DEC_RESULTS");
+  static Writer result(path == nullptr ? "" : path);
+  return result;
+}
+
+// CSV: header line with names, one record per line, quoted strings
+inline Records read_csv(std::istream& stream) {
+  auto split = [](const std::string& line) {
+    std::vector<std::string> result(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+      const char c = line[i];
+      if (quoted) {
+        if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+          result.back() += c;
+          ++i;
+        }
+        else if (c == '"') {
+          quoted = false;
+        }
+        else {
+          result.back() += c;
+        }
+      }
+      else if (c == '"') {
+        quoted = true;
+      }
+      else if (c == ',') {
+        result.emplace_back();
+      }
+      else if (c != '\r') {
+        result.back() += c;
+      }
+    }
+    return result;
+  };
+
+  Records result;
+  std::string line;
+  std::getline(stream, line);
+  const std::vector<std::string> names = split(line);
+  while (std::getline(stream, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    const std::vector<std::string> values = split(line);
+    if (values.size() != names.size()) {
+      throw std::runtime_error("Incorrect CSV line: " + line);
+    }
+    std::map<std::string, std::string> record;
+    for (size_t i = 0; i < names.size(); ++i) {
+      record[names[i]] = values[i];
+    }
+    result.push_back(from_fields(record));
+  }
+  return result;
+}
+
+// JSON: array of flat objects (string and number values only)
+inline Records read_json(std::istream& stream) {
+  const std::string text(
+      (std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>()
+  );
+  size_t i = 0;
+
+  auto error = [&i]() {
+    throw std::runtime_error(
+        "Incorrect JSON at offset " + std::to_string(i)
+    );
+  };
+  auto skip_spaces = [&]() {
+    while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) {
+      ++i;
+    }
+  };
+  auto expect = [&](char c) {
+    skip_spaces();
+    if (i >= text.size() || text[i] != c) {
+      error();
+    }
+    ++i;
+  };
+  auto next_is = [&](char c) {
+    skip_spaces();
+    return i < text.size() && text[i] == c;
+  };
+  auto parse_string = [&]() {
+    expect('"');
+    std::string result;
+    while (i < text.size() && text[i] != '"') {
+      if (text[i] == '\\') {
+        ++i;
+      }
+      if (i < text.size()) {
+        result += text[i];
+        ++i;
+      }
+    }
+    expect('"');
+    return result;
+  };
+  auto parse_value = [&]() {
+    if (next_is('"')) {
+      return parse_string();
+    }
+    const size_t begin = i;
+    while (i < text.size() && text[i] != ',' && text[i] != '}' &&
+        !std::isspace(static_cast<unsigned char>(text[i]))) {
+      ++i;
+    }
+    if (begin == i) {
+      error();
+    }
+    return text.substr(begin, i - begin);
+  };
+
+  Records result;
+  expect('[');
+  while (!next_is(']')) {
+    if (!result.empty()) {
+      expect(',');
+    }
+    std::map<std::string, std::string> record;
+    expect('{');
+    while (!next_is('}')) {
+      if (!record.empty()) {
+        expect(',');
+      }
+      const std::string name = parse_string();
+      expect(':');
+      record[name] = parse_value();
+    }
+    expect('}');
+    result.push_back(from_fields(record));
+  }
+  expect(']');
+  return result;
+}
+
+// Text output of `int_dec_format_test` (see results/ directory):
+//   "Converting N <type> with <digit> base-10 digits ... to buffer B bytes"
+//   "(+N%) <algo> [avg:X ... runs:R conv_ops:C]"
+// Only average is known: all times are `avg` (clock ticks per run).
+// Tick is platform specific (1 ns for gcc/clang, 100 ns for msvc 2013):
+// detected by `ms` (same average in milliseconds) of the longest run,
+// rounded to a power of 10. No `ms` > 0 in the file: 1 ns.
+inline Records read_text(std::istream& stream) {
+  Records result;
+  Config config;
+  bool have_config = false;
+
+  // longest run: the most precise `ms`
+  double tick_avg = 0;
+  double tick_ms = 0;
+
+  std::string line;
+  while (std::getline(stream, line)) {
+    const std::string converting("Converting ");
+    if (line.compare(0, converting.size(), converting) == 0) {
+      const size_t with = line.find(" with ");
+      const size_t digits = line.find(" base-10 digits");
+      const size_t buffer = line.find("to buffer ");
+      if (with == std::string::npos || digits == std::string::npos ||
+          buffer == std::string::npos) {
+        continue;
+      }
+      std::istringstream values(line.substr(converting.size()));
+      values >> config.values;
+      const size_t type_begin = line.find(' ', converting.size()) + 1;
+      config.operation = "format";
+      config.type = line.substr(type_begin, with - type_begin);
+      const std::string digit = line.substr(with + 6, digits - with - 6);
+      config.digit = (digit == "ANY") ? 0 : std::stoi(digit);
+      config.sign = (line.find("(no sign)") == std::string::npos);
+      config.same_size = (line.find("(same size)") != std::string::npos);
+      config.distribution = "uniform";
+      const size_t separated = line.find("separated by ");
+      config.separator = (separated == std::string::npos) ? "none" :
+          line.substr(separated + 13, buffer - separated - 14);
+      config.buffer = std::stoul(line.substr(buffer + 10));
+      have_config = true;
+      continue;
+    }
+
+    const size_t open = line.find(" [avg:");
+    if (!have_config || open == std::string::npos) {
+      continue;
+    }
+    const size_t name_begin = line.rfind(' ', open - 1) + 1;
+    Record record(config, line.substr(name_begin, open - name_begin));
+
+    std::map<std::string, double> values;
+    std::istringstream items(line.substr(open + 2, line.find(']') - open - 2));
+    std::string item;
+    while (items >> item) {
+      const size_t colon = item.find(':');
+      if (colon != std::string::npos) {
+        values[item.substr(0, colon)] = std::atof(item.c_str() + colon + 1);
+      }
+    }
+    if (values["conv_ops"] == 0 || values["runs"] == 0) {
+      continue;
+    }
+    const double avg = values["avg"];
+    if (values["ms"] > tick_ms && avg > 0) {
+      tick_avg = avg;
+      tick_ms = values["ms"];
+    }
+    // ticks, converted to ns below
+    record.median_ns = avg;
+    record.ns_per_value = avg / (values["conv_ops"] / values["runs"]);
+    record.samples = static_cast<size_t>(values["runs"]);
+    result.push_back(record);
+  }
+
+  double ns_per_tick = 1;
+  if (tick_ms > 0) {
+    const double ratio = tick_ms * 1e6 / tick_avg;
+    ns_per_tick = std::pow(10, std::round(std::log10(ratio)));
+  }
+  for (auto& i: result) {
+    i.median_ns *= ns_per_tick;
+    i.ns_per_value *= ns_per_tick;
+  }
+  return result;
+}
+
+// Format detected by the first non-space char: '[' - JSON,
+// "operation," - CSV, otherwise text output
+inline Records read(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Can't open results file: " + path);
+  }
+  file >> std::ws;
+  if (file.peek() == '[') {
+    return read_json(file);
+  }
+  const std::string header("operation,");
+  std::string first(header.size(), '\0');
+  file.read(&first[0], static_cast<std::streamsize>(header.size()));
+  file.clear();
+  file.seekg(0);
+  if (first == header) {
+    return read_csv(file);
+  }
+  return read_text(file);
+}
+
+} // namespace results
+
+#endif // RESULTS_HPP_
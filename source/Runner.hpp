@@ -4,172 +4,96 @@
 // Copyright (c) 2014, Ruslan Baratov
 // All rights reserved.
 
-#include <iomanip> // std::setw
-#include <chrono>
-#include <cmath> // std::sqrt
-#include <numeric> // std::accumulate
 #include <cassert>
 #include <stdexcept> // std::runtime_error
 #include <sstream> // std::ostringstream
+#include <type_traits> // std::integral_constant
+#include <typeinfo> // typeid
+#include <vector>
 
+#include "Benchmark.hpp"
+#include "Format.hpp"
 #include "Input.hpp"
+#include "IsExactSize.hpp"
+#include "IsMultithreaded.hpp"
+#include "IsSupported.hpp"
 #include "Output.hpp"
-#include "Timer.hpp"
-
-template <class Input, class Algo>
-class Runner {
- public:
-  using Duration = Timer::Duration;
-  using Durations = std::vector<Duration>;
 
+// Iterations of tests without calibration (see Benchmark.hpp)
 #if !defined(TOTAL_ITERATIONS)
 # define TOTAL_ITERATIONS 30000000
 #endif
 
-#if defined(NDEBUG)
-  static const int TIMED_RUN = 10;
-#else
-  static const int TIMED_RUN = 1;
-#endif
+// `Format` - expected format of values (see Format.hpp)
+template <class Input, class Algo, class Format = format::Plain>
+class Runner: public benchmark::SampledTask {
+ public:
+  static const bool enabled = Algo::enabled &&
+      IsSupported<Algo, typename Input::value_t>::value;
 
   Runner(const Input& input, Output& output, const char* name):
+      benchmark::SampledTask(name),
       input_(input),
-      output_(output),
-#if defined(NDEBUG)
-      timer_iterations_(TOTAL_ITERATIONS / static_cast<int>(input.size()) / TIMED_RUN),
-#else
-      timer_iterations_(1),
-#endif
-      name_(name)
+      output_(output)
   {
-    assert(timer_iterations_ > 0);
 #if !defined(NDEBUG)
-    test_algo();
+    if (enabled) {
+      test_algo();
+    }
 #endif
   }
 
-  void run() {
-    if (!Algo::enabled) {
+  // One sample, first call: warm-up and calibration
+  void run() override {
+    if (!enabled) {
       return;
     }
 #if !defined(NDEBUG)
     output_.clear();
 #endif
-    for (int i = 0; i < TIMED_RUN; ++i) {
-      const Timer::TimePoint start = Timer::now();
-
-      for (int j = 0; j < timer_iterations_; ++j) {
-        Algo::run(output_.buffer(), input_.values());
-
-        // prevent compiler optimization
-        output_.use_buffer(name_);
-      }
-
-      const Timer::TimePoint stop = Timer::now();
-      durations_.push_back(stop - start);
-    }
-  }
-
-  Duration average() const {
-    return average(durations_);
-  }
-
-  const Durations& durations() const {
-    return durations_;
-  }
-
-  static const Durations& pick_best_durations(
-      const Durations& x1, const Durations& x2
-  ) {
-    if (average(x1) < average(x2)) {
-      return x1;
+    if (IsMultithreaded<Algo>::value) {
+      const benchmark::Unpinned unpinned;
+      sample_algo();
     }
     else {
-      return x2;
+      sample_algo();
     }
   }
 
-  void output_result(Duration best) const {
-    output_result(best, name_, durations_, timer_iterations_, input_);
-  }
-
-  int timer_iterations() const {
-    return timer_iterations_;
-  }
-
-  static void output_result(
-      Duration best,
-      std::string name,
-      const Durations& durations,
-      int timer_iterations,
-      const Input& input
-  ) {
-    if (!Algo::enabled) {
-      return;
-    }
-
-    const Duration avg = average(durations);
-
-    std::string output_name;
-    if (avg == best) {
-      output_name += "(!)";
-    }
-    else {
-      assert(best < avg);
-      assert(best.count() > 0);
-      auto overhead = 100 * (avg - best).count() / best.count();
-      output_name += "(+" + std::to_string(overhead) + "%)";
+  // Workers of multithreaded algorithm may be created before counters
+  // of this task (see parallel::Workers): not counted, totals of the
+  // calling thread alone would be wrong
+  perf::Values counters() const override {
+    if (IsMultithreaded<Algo>::value) {
+      return perf::Values();
     }
+    return benchmark::SampledTask::counters();
+  }
 
-    output_name += " ";
-    output_name += name;
-
-    double avg_tick = static_cast<double>(avg.count());
-    double sd(0);
-    for (auto i: durations) {
-      double x(i.count() - avg_tick);
-      sd += x * x;
-    }
-    sd = sd / durations.size();
-    sd = std::sqrt(sd);
-    const double var = (sd / avg_tick) * 100.0;
-
-    uint64_t input_size = input.values().size();
-    uint64_t conv_ops = durations.size() * timer_iterations * input_size;
-    using Ms = std::chrono::milliseconds;
-    std::cout << std::setw(40) << output_name << " [";
-    std::cout << "avg:" << avg.count() << " ";
-    std::cout << "var:" << var << "% ";
-    std::cout << "ms:" << std::chrono::duration_cast<Ms>(avg).count() << " ";
-    std::cout << "runs:" << durations.size() << " ";
-    std::cout << "conv_ops:" << conv_ops;
-    std::cout << "]" << std::endl;
+  // Compared only with algorithms of the same output format: hex, fixed
+  // or padded text is not an alternative to plain decimal
+  const std::type_info& group() const override {
+    return typeid(Format);
   }
 
  private:
   using value_t = typename Input::value_t;
+  using separator_t = typename Input::separator_t;
 
-  static Duration average(const Durations& durations) {
-    if (!Algo::enabled) {
-      return Duration::max();
-    }
+  using Supported = std::integral_constant<bool, enabled>;
 
-    if (durations.empty()) {
-      throw std::runtime_error("No run detected");
-    }
-    Duration sum = std::accumulate(
-        durations.begin(), durations.end(), Duration(0)
-    );
-    Duration result = sum / durations.size();
-    if (result.count() != 0) {
-      return result;
-    }
+  static char* run_algo(char* buffer, const typename Input::Vector& in) {
+    return run_algo(buffer, in, Supported());
+  }
 
-#if defined(NDEBUG)
-    throw std::runtime_error("Too fast (:");
-#else
-    return Duration(1);
-#endif
+  static char* run_algo(
+      char* buffer, const typename Input::Vector& in, std::true_type
+  ) {
+    return Algo::template run<separator_t>(buffer, in);
+  }
+
+  static char* run_algo(char*, const typename Input::Vector&, std::false_type) {
+    throw std::runtime_error("Algorithm is not supported");
   }
 
   void test_algo() {
@@ -186,6 +110,17 @@ class Runner {
     test_algo_iteration(5248118ll);
     test_algo_iteration(-5248118ll);
     test_algo_iteration(-848ll);
+
+    // leading zeros of fixed-point fraction (see algos/fixed.hpp)
+    test_algo_iteration(1);
+    test_algo_iteration(-1);
+    test_algo_iteration(99);
+    test_algo_iteration(100);
+    test_algo_iteration(-100);
+    test_algo_iteration(12345);
+    test_algo_iteration(-12345);
+    test_algo_iteration(1000000ll);
+    test_algo_iteration(-1000001ll);
   }
 
   template <class T>
@@ -195,25 +130,59 @@ class Runner {
     vector.push_back(value);
 
     std::ostringstream result;
-    result << value;
+    Format::write(result, value);
 
-    std::vector<char> buffer;
-    buffer.resize(result.str().size() * 2);
-    Algo::run(buffer.data(), vector);
+    test_algo_vector(vector, result.str());
 
-    if (std::string(buffer.data()) != result.str()) {
-      std::cerr << "Convert " << value;
-      std::cerr << " failed for " << name_ << std::endl;
+    // two values, check separator
+    vector.push_back(value);
+    test_algo_vector(vector, result.str() + separator_t::str() + result.str());
+  }
+
+  void test_algo_vector(
+      const typename Input::Vector& vector, const std::string& expected
+  ) {
+    std::vector<char> buffer;
+    buffer.resize((expected.size() + separator_t::size) * 2);
+    const char* end = run_algo(buffer.data(), vector);
+
+    const bool end_ok = (end == buffer.data() + expected.size());
+    if (std::string(buffer.data()) != expected || !end_ok) {
+      std::cerr << "Convert " << vector.back();
+      std::cerr << " failed for " << name();
+      std::cerr << " (separator: " << separator_t::name() << ")" << std::endl;
       throw std::runtime_error("Incorrect algorithm");
     }
   }
 
+  void sample_algo() {
+    sample_algo(std::integral_constant<bool, IsExactSize<Algo>::value>());
+  }
+
+  void sample_algo(std::false_type) {
+    sample([this]() {
+      run_algo(output_.buffer(), input_.values());
+
+      // prevent compiler optimization
+      benchmark::escape(output_.buffer());
+      output_.use_buffer(name());
+    });
+  }
+
+  // Buffer of exact size: allocated by the first run, reused by the next
+  void sample_algo(std::true_type) {
+    sample([this]() {
+      Algo::template generate<separator_t>(exact_, input_.values());
+
+      // prevent compiler optimization
+      benchmark::escape(exact_.data());
+      output_.use_buffer(exact_.data(), name());
+    });
+  }
+
   const Input& input_;
   Output& output_;
-
-  const int timer_iterations_;
-  const char* name_;
-  Durations durations_;
+  std::vector<char> exact_;
 };
 
 #endif // RUNNER_HPP_
@@ -0,0 +1,81 @@
+#ifndef SEPARATOR_HPP_
+#define SEPARATOR_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::copy
+#include <cstddef> // size_t
+#include <string>
+
+// Separator policies for delimited output:
+//   * separator::None - values concatenated
+//   * separator::Char<','> - one char
+//   * separator::String<'\r', '\n'> - any compile-time string
+// Separator is written by kernel in the same pass after every value,
+// the last one is overwritten by terminating '\0' (see `terminate`),
+// so buffer should have `size` extra bytes.
+namespace separator {
+
+template <char... chars>
+class String {
+ public:
+  static const size_t size = sizeof...(chars);
+
+  static void write(char*& sink) {
+    static const char data[] = { chars..., '\0' };
+    sink = std::copy(data, data + size, sink);
+  }
+
+  static std::string str() {
+    return std::string{ chars... };
+  }
+
+  // Printable name, e.g. "','" or "'\n'"
+  static std::string name() {
+    if (size == 0) {
+      return "none";
+    }
+    std::string result("'");
+    for (char c: str()) {
+      switch (c) {
+        case '\n':
+          result += "\\n";
+          break;
+        case '\r':
+          result += "\\r";
+          break;
+        case '\t':
+          result += "\\t";
+          break;
+        default:
+          result += c;
+      }
+    }
+    result += "'";
+    return result;
+  }
+};
+
+template <char c>
+using Char = String<c>;
+
+using None = String<>;
+using Comma = Char<','>;
+using Newline = Char<'\n'>;
+using CrLf = String<'\r', '\n'>;
+
+// Remove separator after the last value and terminate string.
+// Return end of text (position of '\0')
+template <class Separator, class Vector>
+inline char* terminate(char* sink, const Vector& in) {
+  if (!in.empty()) {
+    sink -= Separator::size;
+  }
+  *sink = '\0';
+  return sink;
+}
+
+} // namespace separator
+
+#endif // SEPARATOR_HPP_
@@ -0,0 +1,71 @@
+#ifndef SPSC_RING_HPP_
+#define SPSC_RING_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <atomic>
+#include <cassert> // assert
+#include <vector>
+
+// Lock-free ring of `capacity` slots for one producer and one consumer
+// thread. Slots are allocated once and reused (e.g. chunk buffers):
+//   * producer: fill `back()` (null if ring is full), then `push()`
+//   * consumer: read `front()` (null if ring is empty), then `pop()`
+// Counters are never wrapped, slot index is `counter % capacity`.
+template <class T>
+class SpscRing {
+ public:
+  SpscRing(size_t capacity, const T& slot):
+      slots_(capacity, slot),
+      head_(0),
+      tail_(0) {
+    assert(capacity > 0);
+  }
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // Producer
+  T* back() {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+      return nullptr;
+    }
+    return &slots_[tail % slots_.size()];
+  }
+
+  void push() {
+    tail_.store(
+        tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release
+    );
+  }
+
+  // Consumer
+  T* front() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots_[head % slots_.size()];
+  }
+
+  void pop() {
+    head_.store(
+        head_.load(std::memory_order_relaxed) + 1, std::memory_order_release
+    );
+  }
+
+ private:
+  enum {
+    CACHE_LINE = 64
+  };
+
+  std::vector<T> slots_;
+
+  // head and tail on different cache lines (no false sharing)
+  alignas(CACHE_LINE) std::atomic<size_t> head_;
+  alignas(CACHE_LINE) std::atomic<size_t> tail_;
+};
+
+#endif // SPSC_RING_HPP_
@@ -0,0 +1,166 @@
+#ifndef STATISTICS_HPP_
+#define STATISTICS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::sort
+#include <cassert> // assert
+#include <chrono> // std::chrono::duration
+#include <cmath> // std::sqrt
+#include <cstdlib> // std::abs
+#include <vector>
+
+namespace benchmark {
+
+// Time of one iteration (nanoseconds, not rounded)
+using Duration = std::chrono::duration<double, std::nano>;
+using Durations = std::vector<Duration>;
+
+// Robust summary of samples:
+//   * outliers (farther than 3 scaled MAD from median) rejected
+//   * median, percentiles, mean of the rest
+//   * 95% confidence interval of median (order statistics,
+//     normal approximation of binomial distribution)
+class Statistics {
+ public:
+  enum {
+    MIN_SAMPLES = 5
+  };
+
+  Statistics():
+      outliers_(0),
+      median_(0),
+      mean_(0),
+      mad_(0),
+      ci_low_(0),
+      ci_high_(0) {
+  }
+
+  explicit Statistics(Durations samples):
+      outliers_(0),
+      median_(0),
+      mean_(0),
+      mad_(0),
+      ci_low_(0),
+      ci_high_(0) {
+    if (samples.empty()) {
+      return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const Duration median = median_of(samples);
+
+    Durations deviations;
+    for (auto i: samples) {
+      deviations.push_back(Duration(std::abs((i - median).count())));
+    }
+    std::sort(deviations.begin(), deviations.end());
+    mad_ = median_of(deviations);
+
+    // 1.4826: MAD to standard deviation for normal distribution
+    const Duration limit = 3 * 1.4826 * mad_;
+    for (auto i: samples) {
+      if (mad_.count() == 0 || Duration(std::abs((i - median).count())) <= limit) {
+        samples_.push_back(i);
+      }
+      else {
+        ++outliers_;
+      }
+    }
+    assert(!samples_.empty()); // at least median is not an outlier
+
+    median_ = median_of(samples_);
+
+    Duration sum(0);
+    for (auto i: samples_) {
+      sum += i;
+    }
+    mean_ = sum / static_cast<double>(samples_.size());
+
+    // ranks n/2 -+ 1.96 * sqrt(n) / 2
+    const double n = static_cast<double>(samples_.size());
+    const double half_width = 1.96 * std::sqrt(n) / 2;
+    ci_low_ = at_rank(n / 2 - half_width);
+    ci_high_ = at_rank(n / 2 + half_width + 1);
+  }
+
+  bool empty() const {
+    return samples_.empty();
+  }
+
+  // Samples without outliers
+  size_t size() const {
+    return samples_.size();
+  }
+
+  size_t outliers() const {
+    return outliers_;
+  }
+
+  Duration median() const {
+    return median_;
+  }
+
+  Duration mean() const {
+    return mean_;
+  }
+
+  // Median absolute deviation (before outliers rejection)
+  Duration mad() const {
+    return mad_;
+  }
+
+  Duration ci_low() const {
+    return ci_low_;
+  }
+
+  Duration ci_high() const {
+    return ci_high_;
+  }
+
+  // Nearest rank, `percent` in range [0, 100]
+  Duration percentile(double percent) const {
+    assert(percent >= 0 && percent <= 100);
+    return at_rank(percent / 100 * static_cast<double>(samples_.size()));
+  }
+
+  // Confidence intervals of medians don't overlap (too few samples:
+  // interval is not informative, never significant)
+  bool significantly_faster(const Statistics& other) const {
+    if (size() < MIN_SAMPLES || other.size() < MIN_SAMPLES) {
+      return false;
+    }
+    return ci_high_ < other.ci_low_;
+  }
+
+ private:
+  static Duration median_of(const Durations& sorted) {
+    assert(!sorted.empty());
+    const size_t middle = sorted.size() / 2;
+    if (sorted.size() % 2 == 1) {
+      return sorted[middle];
+    }
+    return (sorted[middle - 1] + sorted[middle]) / 2.0;
+  }
+
+  // 1-based rank, clamped to [1, size]
+  Duration at_rank(double rank) const {
+    assert(!samples_.empty());
+    const double max_rank = static_cast<double>(samples_.size());
+    rank = std::min(std::max(std::ceil(rank), 1.0), max_rank);
+    return samples_[static_cast<size_t>(rank) - 1];
+  }
+
+  Durations samples_;
+  size_t outliers_;
+  Duration median_;
+  Duration mean_;
+  Duration mad_;
+  Duration ci_low_;
+  Duration ci_high_;
+};
+
+} // namespace benchmark
+
+#endif // STATISTICS_HPP_
@@ -8,7 +8,8 @@
 
 class Timer {
  public:
-  using Clock = std::chrono::high_resolution_clock;
+  // monotonic: not affected by system time adjustments
+  using Clock = std::chrono::steady_clock;
   using Duration = Clock::duration;
   using TimePoint = Clock::time_point;
 
@@ -4,6 +4,9 @@
 #include <cassert> // assert
 #include <boost/config.hpp> // BOOST_CLANG
 
+#include "CountDigitsLzcnt.hpp"
+#include "Int128.hpp"
+
 // https://www.facebook.com/notes/facebook-engineering/three-optimization-tips-for-c/10151361643253920
 
 namespace alexandrescu {
@@ -81,26 +84,11 @@ inline const char* cache_digits() {
   ;
 }
 
-template <class Integer>
-inline void generate(Iterator& sink_out, Integer input_value) {
-  using Unsigned = typename std::make_unsigned<Integer>::type;
-  Unsigned value(input_value);
-
-  Iterator sink = sink_out;
-
-  if (input_value < 0) {
-    *sink = '-';
-    ++sink;
-    value = 0 - value;
-  }
-
-  size_t digits = count_digits(value);
-  sink += digits;
-  sink_out = sink;
-
+// Fill digits "from the end"
+template <class Unsigned>
+inline void fill(Iterator sink, Unsigned value) {
   const char* cache = cache_digits();
 
-  assert(value >= 0);
   while (value >= 100) {
     size_t index = (value % 100) * 2; // 0..198
     value /= 100;
@@ -129,6 +117,52 @@ inline void generate(Iterator& sink_out, Integer input_value) {
   }
 }
 
+#if HAVE_INT128
+// Same split as `counting::fill`
+inline void fill(Iterator sink, uint128_t value) {
+  while (!int128::fits_64(value)) {
+    uint64_t low;
+    value = int128::divide_10_19(value, low);
+    int128::fill_19(sink, low, cache_digits());
+    sink -= 19;
+  }
+
+  fill(sink, static_cast<uint64_t>(value));
+}
+#endif
+
+// Digit counting policies of `generate`: `count(Unsigned)`
+class Tree {
+ public:
+  template <class Unsigned>
+  static size_t count(Unsigned value) {
+    return count_digits(value);
+  }
+};
+
+using Lzcnt = CountDigitsLzcnt;
+
+template <class Integer, class Counter = Tree>
+inline void generate(Iterator& sink_out, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  Iterator sink = sink_out;
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+
+  size_t digits = Counter::count(value);
+  sink += digits;
+  sink_out = sink;
+
+  assert(value >= 0);
+  fill(sink, value);
+}
+
 } // namespace alexandrescu
 
 #endif // ALGOS_ALEXANDRESCU_HPP_
@@ -0,0 +1,208 @@
+#ifndef ALGOS_BUCKETED_HPP_
+#define ALGOS_BUCKETED_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::copy
+#include <cstdint> // uint64_t
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::make_unsigned, std::conditional, std::is_same
+#include <vector>
+
+#include "CountDigitsLzcnt.hpp"
+#include "Int128.hpp"
+#include "Separator.hpp"
+#include "counting.hpp"
+
+// Batch conversion of mixed-length input without data-dependent branches
+// per value:
+// 1) histogram of number of digits (branch-free `CountDigitsLzcnt`),
+//    prefix sum give bucket starts
+// 2) classify: running offset gives output position of every value,
+//    sign and separator written in place, (value, end of digits) stored
+//    to the bucket of its number of digits. No index sort, no gather:
+//    kernels read values from buckets.
+// 3) every bucket converted by kernel with fixed number of digits
+//    (fully unrolled), sequential read of the bucket, digits stored to
+//    their positions.
+//    Sign written unconditionally and overwritten by the first digit
+//    if value is not negative.
+namespace bucketed {
+
+using Iterator = char*;
+
+// Narrowest type for `digits` digits: 128-bit arithmetic only if needed
+template <int digits, class Unsigned>
+class Narrow {
+ public:
+  using type = typename std::conditional<
+      (digits <= 19 && (sizeof(Unsigned) > sizeof(uint64_t))),
+      uint64_t,
+      Unsigned
+  >::type;
+};
+
+// Exactly `digits` digits "from the end", `sink` points to the position
+// after the last digit. Loop count known at compile time.
+template <int digits>
+class Fixed {
+ public:
+  template <class Unsigned>
+  static void fill(Iterator sink, Unsigned value) {
+    const char* cache = counting::cache_digits();
+    for (int i = 0; i < digits / 2; ++i) {
+      const size_t index = static_cast<size_t>(value % 100) * 2; // 0..198
+      value = static_cast<Unsigned>(value / 100);
+      --sink;
+      *sink = cache[index + 1];
+      --sink;
+      *sink = cache[index];
+    }
+    if (digits % 2 != 0) {
+      --sink;
+      *sink = static_cast<char>('0' + value);
+    }
+  }
+
+#if HAVE_INT128
+  // 19 low digits in 64-bit part (see int128::divide_10_19)
+  static void fill(Iterator sink, uint128_t value) {
+    uint64_t low;
+    value = int128::divide_10_19(value, low);
+    Fixed<19>::fill(sink, low);
+    using High = typename Narrow<digits - 19, uint128_t>::type;
+    Fixed<digits - 19>::fill(sink - 19, static_cast<High>(value));
+  }
+#endif
+};
+
+// Value of bucket, digits end at `buffer + end`
+template <class Unsigned>
+class Entry {
+ public:
+  Unsigned value;
+  size_t end;
+};
+
+// Values of `[begin, end)` with `digits` digits
+template <int digits, class Unsigned>
+inline void convert(
+    Iterator buffer, const Entry<Unsigned>* begin, const Entry<Unsigned>* end
+) {
+  using Narrowed = typename Narrow<digits, Unsigned>::type;
+
+  for (; begin != end; ++begin) {
+    Fixed<digits>::fill(
+        buffer + begin->end, static_cast<Narrowed>(begin->value)
+    );
+  }
+}
+
+// Absolute value
+template <class Unsigned, class Integer>
+inline Unsigned magnitude(Integer value) {
+  return (value < 0) ?
+      0 - static_cast<Unsigned>(value) :
+      static_cast<Unsigned>(value);
+}
+
+// Buckets of `generate` (one after another, grouped by number of digits),
+// reused by next calls: no allocation (and no page faults) per call once
+// grown to the input size
+template <class Unsigned>
+class Scratch {
+ public:
+  std::vector<Entry<Unsigned>> buckets;
+};
+
+// Kernel for runtime number of digits `digits <= max`
+template <int max>
+class Kernels {
+ public:
+  template <class Unsigned>
+  static void convert(
+      int digits,
+      Iterator buffer,
+      const Entry<Unsigned>* begin,
+      const Entry<Unsigned>* end
+  ) {
+    if (digits == max) {
+      bucketed::convert<max>(buffer, begin, end);
+    }
+    else {
+      Kernels<max - 1>::convert(digits, buffer, begin, end);
+    }
+  }
+};
+
+template <>
+class Kernels<0> {
+ public:
+  template <class Unsigned>
+  static void convert(
+      int, Iterator, const Entry<Unsigned>*, const Entry<Unsigned>*
+  ) {
+  }
+};
+
+// Separator written after every value, `buffer` points to the end
+template <class Separator, class Vector, class Unsigned>
+inline void generate(
+    Iterator& buffer, const Vector& in, Scratch<Unsigned>& scratch
+) {
+  using Integer = typename Vector::value_type;
+  static_assert(
+      std::is_same<Unsigned, typename std::make_unsigned<Integer>::type>::value,
+      ""
+  );
+
+  enum {
+    MAX_DIGITS = std::numeric_limits<Unsigned>::digits10 + 1
+  };
+
+  // every element written before read
+  scratch.buckets.resize(in.size());
+  Entry<Unsigned>* buckets = scratch.buckets.data();
+
+  // 1) histogram
+  size_t starts[MAX_DIGITS + 2] = {0}; // counts, then bucket starts
+  for (auto input_value: in) {
+    ++starts[CountDigitsLzcnt::count(magnitude<Unsigned>(input_value)) + 1];
+  }
+  for (int i = 1; i <= MAX_DIGITS + 1; ++i) {
+    starts[i] += starts[i - 1];
+  }
+
+  // 2) classify
+  size_t next[MAX_DIGITS + 1];
+  std::copy(starts, starts + MAX_DIGITS + 1, next);
+  Iterator sink = buffer;
+  for (auto input_value: in) {
+    const Unsigned value = magnitude<Unsigned>(input_value);
+    const size_t count = CountDigitsLzcnt::count(value);
+
+    *sink = '-';
+    sink += (input_value < 0) + count;
+    Entry<Unsigned>& entry = buckets[next[count]++];
+    entry.value = value;
+    entry.end = static_cast<size_t>(sink - buffer);
+    Separator::write(sink);
+  }
+
+  // 3) fixed-length kernels
+  for (int i = 1; i <= MAX_DIGITS; ++i) {
+    if (starts[i] == starts[i + 1]) {
+      continue;
+    }
+    Kernels<MAX_DIGITS>::convert(
+        i, buffer, buckets + starts[i], buckets + starts[i + 1]
+    );
+  }
+
+  buffer = sink;
+}
+
+} // namespace bucketed
+
+#endif // ALGOS_BUCKETED_HPP_
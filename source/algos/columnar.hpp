@@ -0,0 +1,63 @@
+#ifndef ALGOS_COLUMNAR_HPP_
+#define ALGOS_COLUMNAR_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstdint> // int32_t, int64_t
+#include <limits> // std::numeric_limits
+#include <stdexcept> // std::runtime_error
+#include <type_traits> // std::make_unsigned
+#include <vector>
+
+#include "twopass.hpp"
+
+// String column (Apache Arrow layout): text of value `i` is
+// `data[offsets[i], offsets[i + 1])`, no separators, no '\0'.
+// Lengths counted first (see twopass.hpp), data sized exactly, then
+// every value written to its final position. Column is resized, not
+// reallocated: capacity of previous conversion reused, no allocation per
+// value and no allocation at all if capacity is enough.
+namespace columnar {
+
+// `Offset`: int32_t (Arrow `utf8`) or int64_t (`large_utf8`)
+template <class Offset>
+class Column {
+ public:
+  std::vector<Offset> offsets;
+  std::vector<char> data;
+
+  size_t size() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+};
+
+template <class Offset, class Vector>
+inline void convert(const Vector& in, Column<Offset>& column) {
+  using Unsigned = typename std::make_unsigned<typename Vector::value_type>::type;
+
+  // 1) lengths
+  column.offsets.resize(in.size() + 1);
+  size_t total = 0;
+  for (size_t i = 0; i < in.size(); ++i) {
+    column.offsets[i] = static_cast<Offset>(total);
+    total += twopass::length(in[i]);
+  }
+  if (total > static_cast<size_t>(std::numeric_limits<Offset>::max())) {
+    throw std::runtime_error("Column data doesn't fit into offset type");
+  }
+  column.offsets[in.size()] = static_cast<Offset>(total);
+
+  // 2) values
+  column.data.resize(total);
+  char* data = column.data.data();
+  for (size_t i = 0; i < in.size(); ++i) {
+    twopass::write_value<Unsigned>(
+        data + column.offsets[i], data + column.offsets[i + 1], in[i]
+    );
+  }
+}
+
+} // namespace columnar
+
+#endif // ALGOS_COLUMNAR_HPP_
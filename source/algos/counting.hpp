@@ -9,6 +9,8 @@
 #include <limits> // std::numeric_limits
 
 #include "CountDigits.hpp"
+#include "CountDigitsLzcnt.hpp"
+#include "Int128.hpp"
 
 namespace counting {
 
@@ -29,22 +31,10 @@ inline const char* cache_digits() {
 
 using Iterator = char*;
 
-// 1) count digits
-// 2) fill sink "from the end"
-
-// Iterator requirement: RandomAccessIterator
-template <class Integer>
-inline void generate(Iterator& sink_out, Integer input_value) {
-  using Unsigned = typename std::make_unsigned<Integer>::type;
-  Unsigned value(input_value);
-
-  Iterator sink = sink_out;
-
-  if (input_value < 0) {
-    *sink = '-';
-    ++sink;
-    value = 0 - value;
-  }
+// Count digits of unsigned value without division
+template <class Unsigned>
+inline size_t count_digits(Unsigned value) {
+  static_assert(std::is_unsigned<Unsigned>::value, "");
 
   static const int min = 1;
   static const int max = std::numeric_limits<Unsigned>::digits10;
@@ -54,16 +44,30 @@ inline void generate(Iterator& sink_out, Integer input_value) {
   // the real number of digits can be `digits10 + 1`.
   // Counting algorithm checks if `value >= 10^max_digits`, i.e.
   // can return `max_digits + 1`.
-  size_t digits = CountDigits<checks_number>::template count<min, max>(value);
+  return CountDigits<checks_number>::template count<min, max>(value);
+}
 
-  sink += digits;
-  sink_out = sink;
+// Digit counting policies of `generate`: `count(Unsigned)`
+class Bisection {
+ public:
+  template <class Unsigned>
+  static size_t count(Unsigned value) {
+    return count_digits(value);
+  }
+};
+
+using Lzcnt = CountDigitsLzcnt;
 
-  assert(value >= 0); // sanity check
+// Fill digits of unsigned value "from the end",
+// `sink` points to the position after the last digit
+
+// Iterator requirement: RandomAccessIterator
+template <class Unsigned>
+inline void fill(Iterator sink, Unsigned value) {
+  static_assert(std::is_unsigned<Unsigned>::value, "");
 
   const char* cache = cache_digits();
 
-  assert(value >= 0);
   while (value >= 100) {
     size_t index = (value % 100) * 2; // 0..198
     value /= 100;
@@ -92,6 +96,42 @@ inline void generate(Iterator& sink_out, Integer input_value) {
   }
 }
 
+#if HAVE_INT128
+// 19 digits per 128-bit division (see Int128.hpp), the rest by 64-bit code
+inline void fill(Iterator sink, uint128_t value) {
+  while (!int128::fits_64(value)) {
+    uint64_t low;
+    value = int128::divide_10_19(value, low);
+    int128::fill_19(sink, low, cache_digits());
+    sink -= 19;
+  }
+  fill(sink, static_cast<uint64_t>(value));
+}
+#endif
+
+// 1) count digits (`Counter`)
+// 2) fill sink "from the end"
+
+// Iterator requirement: RandomAccessIterator
+template <class Integer, class Counter = Bisection>
+inline void generate(Iterator& sink_out, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  Iterator sink = sink_out;
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+
+  sink += Counter::count(value);
+  sink_out = sink;
+
+  fill(sink, value);
+}
+
 } // namespace counting
 
 #endif // ALGOS_COUNTING_HPP_
@@ -0,0 +1,196 @@
+#ifndef ALGOS_FIXED_HPP_
+#define ALGOS_FIXED_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint64_t
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::make_unsigned
+
+#include "CountDigits.hpp" // Power10
+#include "Int128.hpp"
+#include "counting.hpp"
+
+// Scaled integers (cents, 1e-6 units): value `v` with scale `s` is
+// `v / 10^s` written in one pass, no bytes moved after formatting:
+//   * scale 2: 12345 -> "123.45", -5 -> "-0.05", 100 -> "1.00"
+//   * scale 0: same as `counting`
+// Integer part converted by `counting` (with digits counting), fractional
+// part - exactly `scale` digits with leading zeros.
+namespace fixed {
+
+using Iterator = char*;
+
+// Maximum scale: fraction of 64-bit (128-bit) value
+template <class Unsigned>
+class MaxScale {
+ public:
+  static const int value = (sizeof(Unsigned) > sizeof(uint64_t)) ?
+      std::numeric_limits<Unsigned>::digits10 :
+      std::numeric_limits<uint64_t>::digits10;
+};
+
+template <class Unsigned>
+inline Unsigned power(int scale) {
+  Unsigned result = 1;
+  for (int i = 0; i < scale; ++i) {
+    result *= 10;
+  }
+  return result;
+}
+
+// Exactly `scale` digits "from the end", `sink` points to the position
+// after the last digit
+template <class Unsigned>
+inline void fill_fraction(Iterator sink, Unsigned value, int scale) {
+  const char* cache = counting::cache_digits();
+
+  for (int i = 0; i < scale / 2; ++i) {
+    const size_t index = static_cast<size_t>(value % 100) * 2; // 0..198
+    value = static_cast<Unsigned>(value / 100);
+
+    --sink;
+    *sink = cache[index + 1];
+
+    --sink;
+    *sink = cache[index];
+  }
+
+  if (scale % 2 != 0) {
+    --sink;
+    *sink = static_cast<char>('0' + value);
+  }
+}
+
+// Sign written, `value` is absolute value: `integer` "." `scale` digits
+// of `fraction` (`scale > 0`)
+template <class Counter, class Unsigned>
+inline void write_parts(
+    Iterator& sink_out,
+    Iterator sink,
+    Unsigned integer,
+    Unsigned fraction,
+    int scale
+) {
+  // "0" if value is less than divisor
+  sink += Counter::count(integer);
+  counting::fill(sink, integer);
+
+  *sink = '.';
+  sink += 1 + scale;
+  sink_out = sink;
+
+  if (sizeof(Unsigned) > sizeof(uint64_t) && scale <= 19) {
+    // no 128-bit division per pair
+    fill_fraction(sink, static_cast<uint64_t>(fraction), scale);
+  }
+  else {
+    fill_fraction(sink, fraction, scale);
+  }
+}
+
+// Write sign, return absolute value
+template <class Integer>
+inline typename std::make_unsigned<Integer>::type write_sign(
+    Iterator& sink, Integer input_value
+) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+  return value;
+}
+
+// Runtime scale, `0 <= scale <= MaxScale<...>::value`
+template <class Integer, class Counter = counting::Bisection>
+inline void generate(Iterator& sink_out, Integer input_value, int scale) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+
+  assert(scale >= 0);
+  assert(scale <= MaxScale<Unsigned>::value);
+
+  Iterator sink = sink_out;
+  const Unsigned value = write_sign(sink, input_value);
+
+  if (scale == 0) {
+    sink += Counter::count(value);
+    sink_out = sink;
+    counting::fill(sink, value);
+    return;
+  }
+
+  Unsigned integer = 0;
+  Unsigned fraction = value;
+  if (scale <= std::numeric_limits<Unsigned>::digits10) {
+    // otherwise `10^scale` doesn't fit into Unsigned and value is less
+    const Unsigned divisor = power<Unsigned>(scale);
+    integer = static_cast<Unsigned>(value / divisor);
+    fraction = static_cast<Unsigned>(value % divisor);
+  }
+
+  write_parts<Counter>(sink_out, sink, integer, fraction, scale);
+}
+
+// `10^scale` fits into `Unsigned`: divided by constant (multiply by
+// reciprocal), otherwise value is less than `10^scale`
+template <
+    int scale,
+    class Unsigned,
+    bool fits = (scale <= std::numeric_limits<Unsigned>::digits10)
+>
+class Split {
+ public:
+  static Unsigned integer(Unsigned value) {
+    return static_cast<Unsigned>(value / divisor());
+  }
+
+  static Unsigned fraction(Unsigned value) {
+    return static_cast<Unsigned>(value % divisor());
+  }
+
+ private:
+  static Unsigned divisor() {
+    return static_cast<Unsigned>(Power10<scale>::value);
+  }
+};
+
+template <int scale, class Unsigned>
+class Split<scale, Unsigned, false> {
+ public:
+  static Unsigned integer(Unsigned) {
+    return 0;
+  }
+
+  static Unsigned fraction(Unsigned value) {
+    return value;
+  }
+};
+
+// Scale known at compile time: division by constant, fraction loop
+// unrolled
+template <int scale, class Integer>
+inline void generate(Iterator& sink_out, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  static_assert(scale > 0, "");
+  static_assert(scale <= MaxScale<Unsigned>::value, "");
+
+  Iterator sink = sink_out;
+  const Unsigned value = write_sign(sink, input_value);
+
+  write_parts<counting::Bisection>(
+      sink_out,
+      sink,
+      Split<scale, Unsigned>::integer(value),
+      Split<scale, Unsigned>::fraction(value),
+      scale
+  );
+}
+
+} // namespace fixed
+
+#endif // ALGOS_FIXED_HPP_
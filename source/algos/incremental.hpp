@@ -0,0 +1,142 @@
+#ifndef ALGOS_INCREMENTAL_HPP_
+#define ALGOS_INCREMENTAL_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstdint> // uint32_t, uint64_t
+#include <cstring> // std::memcpy
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::make_unsigned
+
+#include "CountDigits.hpp"
+#include "Int128.hpp"
+#include "counting.hpp"
+#include "swar.hpp"
+
+// Sequence-aware conversion (row numbers, IDs, timestamps): small delta
+// is added to the previous value held as text of the high digits plus
+// number of the low 8 digits. Only the low part is recomputed: one add
+// and one `swar::encode_8_digits`, high digits copied by fixed size copy
+// (unchanged while low part doesn't overflow). No per digit carry loop
+// and no reading back of just written text (store forwarding stalls).
+// Value converted by `counting` if it is negative, less than previous,
+// delta is not small, low part overflows or number of digits changes.
+namespace incremental {
+
+using Iterator = char*;
+
+enum {
+  // larger delta: conversion from scratch
+  MAX_DELTA = 1000,
+
+  LOW_DIGITS = 8
+};
+
+// Text of non-negative value
+template <class Unsigned>
+class Text {
+ public:
+  Text(): size_(0), low_(0), limit_(0), high_() {
+  }
+
+  // `begin..end` - text of `value`
+  void assign(const char* begin, const char* end, Unsigned value) {
+    size_ = static_cast<size_t>(end - begin);
+    low_ = static_cast<uint32_t>(value % Power10<LOW_DIGITS>::value);
+    limit_ = 1;
+    for (size_t i = 0; i < size_ && i < LOW_DIGITS; ++i) {
+      limit_ *= 10;
+    }
+    if (size_ > LOW_DIGITS) {
+      std::memcpy(high_, begin, size_ - LOW_DIGITS);
+    }
+  }
+
+  // `delta < MAX_DELTA`. False if low part overflows or number of digits
+  // changes (text is not valid anymore).
+  bool add(unsigned delta) {
+    low_ += delta;
+    return low_ < limit_;
+  }
+
+  // `size()` bytes written, `LOW_DIGITS` if text is shorter
+  void write(Iterator sink) const {
+    const uint64_t chars = swar::encode_8_digits(low_);
+    if (size_ > LOW_DIGITS) {
+      // 8-byte blocks, the last one overlapped by the low digits
+      for (size_t i = 0; i + LOW_DIGITS < size_; i += 8) {
+        std::memcpy(sink + i, high_ + i, 8);
+      }
+      swar::store(sink + size_ - LOW_DIGITS, chars);
+    }
+    else {
+      // leading zero chars shifted out
+      swar::store(sink, chars >> (8 * (LOW_DIGITS - size_)));
+    }
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  size_t size_;
+  uint32_t low_; // last `LOW_DIGITS` digits, `low_ < limit_`
+  uint32_t limit_; // 10^(number of low digits)
+
+  enum {
+    DIGITS = std::numeric_limits<Unsigned>::digits10 + 1,
+    HIGH_DIGITS = (DIGITS > LOW_DIGITS) ? (DIGITS - LOW_DIGITS) : 1
+  };
+
+  // high digits, rounded up to 8-byte blocks
+  char high_[(HIGH_DIGITS + 7) / 8 * 8];
+};
+
+template <class Separator, class Vector>
+inline void generate(Iterator& buffer, const Vector& in) {
+  using Integer = typename Vector::value_type;
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+
+  Text<Unsigned> text;
+  Integer previous = 0;
+  bool have_previous = false; // `text` is text of `previous`
+
+  // `Text::write` may write up to 7 bytes after the end of the number
+  // shorter than `LOW_DIGITS` (as in `swar`): every next value writes at
+  // least one byte, such numbers of the last values converted by `counting`
+  const size_t size = in.size();
+  const size_t end = (size > LOW_DIGITS) ? (size - LOW_DIGITS) : 0;
+
+  // local copy: stores of chars don't reload it
+  Iterator sink = buffer;
+
+  for (size_t i = 0; i < size; ++i) {
+    const Integer value = in[i];
+
+    // `previous >= 0`: no overflow in `value - previous`
+    if (have_previous && (i < end || text.size() > LOW_DIGITS) &&
+        value >= previous && value - previous < MAX_DELTA &&
+        text.add(static_cast<unsigned>(value - previous))) {
+      text.write(sink);
+      sink += text.size();
+    }
+    else {
+      const Iterator begin = sink;
+      counting::generate(sink, value);
+      have_previous = (value >= 0);
+      if (have_previous) {
+        text.assign(begin, sink, static_cast<Unsigned>(value));
+      }
+    }
+    previous = value;
+    Separator::write(sink);
+  }
+
+  buffer = sink;
+}
+
+} // namespace incremental
+
+#endif // ALGOS_INCREMENTAL_HPP_
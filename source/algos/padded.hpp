@@ -0,0 +1,166 @@
+#ifndef ALGOS_PADDED_HPP_
+#define ALGOS_PADDED_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint32_t
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::make_unsigned, std::conditional
+
+#include "CountDigits.hpp"
+#include "Int128.hpp"
+#include "reciprocal.hpp"
+
+// Fixed width output: every value takes exactly `W` bytes (by default
+// `Width<Integer>::value`, widest value of the type), right-aligned.
+// No digits counting, all digits written unconditionally (fixed number of
+// steps), pointer always moved by width:
+//   * pad '0': "-0042", "00042"
+//   * pad ' ': "  -42", "   42"
+// Value wider than `W` keeps its sign and low digits, as field of
+// fixed-layout record: "-123456" -> "-3456" for W = 5.
+namespace padded {
+
+using Iterator = char*;
+
+// `W` of `generate`: width of the type
+static const size_t type_width = 0;
+
+template <class Integer, size_t W = type_width>
+class Width {
+ public:
+  static const bool is_signed = std::numeric_limits<Integer>::is_signed;
+
+  // maximum number of digits of the type
+  static const size_t type_digits =
+      std::numeric_limits<Integer>::digits10 + 1;
+
+  // digits + sign
+  static const size_t value =
+      (W == type_width) ? type_digits + (is_signed ? 1 : 0) : W;
+
+  static_assert(value > (is_signed ? 1 : 0), "No room for digits");
+
+  // number of digits written
+  static const size_t digits = value - (is_signed ? 1 : 0);
+};
+
+// Low `digits` digits of value (narrower value as is)
+template <size_t digits, class Unsigned>
+inline Unsigned low_digits(Unsigned value, std::true_type) {
+  return static_cast<Unsigned>(value % Power10<digits>::value);
+}
+
+template <size_t digits, class Unsigned>
+inline Unsigned low_digits(Unsigned value, std::false_type) {
+  return value;
+}
+
+// Write exactly `digits` digits with leading zeros
+template <size_t digits>
+inline void write_fixed(Iterator sink, uint64_t value) {
+  static_assert(digits <= 20, "");
+
+  if (digits <= 8) {
+    reciprocal::write_digits(sink, static_cast<uint32_t>(value), digits);
+    return;
+  }
+
+  const uint64_t p8 = Power10<8>::value;
+  const uint32_t low = static_cast<uint32_t>(value % p8);
+  value /= p8;
+
+  if (digits <= 16) {
+    reciprocal::write_digits(sink, static_cast<uint32_t>(value), digits - 8);
+    reciprocal::write_8_digits(sink + digits - 8, low);
+    return;
+  }
+
+  const uint32_t middle = static_cast<uint32_t>(value % p8);
+  value /= p8;
+
+  reciprocal::write_digits(sink, static_cast<uint32_t>(value), digits - 16);
+  reciprocal::write_8_digits(sink + digits - 16, middle);
+  reciprocal::write_8_digits(sink + digits - 8, low);
+}
+
+#if HAVE_INT128
+// 39 digits: 1 + 19 + 19
+template <size_t digits>
+inline void write_fixed(Iterator sink, uint128_t value) {
+  static_assert(digits == 39, "");
+
+  uint64_t low;
+  uint64_t middle;
+  value = int128::divide_10_19(value, low);
+  value = int128::divide_10_19(value, middle);
+
+  write_fixed<1>(sink, static_cast<uint64_t>(value));
+  write_fixed<19>(sink + 1, middle);
+  write_fixed<19>(sink + 20, low);
+}
+#endif
+
+template <char pad, size_t W = type_width, class Integer>
+inline void generate(Iterator& sink, Integer input_value) {
+  static_assert(pad == '0' || pad == ' ', "");
+
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  static const bool is_signed = std::numeric_limits<Integer>::is_signed;
+  static const size_t digits = Width<Integer, W>::digits;
+  static const size_t width = Width<Integer, W>::value;
+
+  const bool negative = (input_value < 0);
+  Unsigned value(input_value);
+  value = negative ? static_cast<Unsigned>(0 - value) : value;
+
+  using Narrow = std::integral_constant<
+      bool, (digits < Width<Integer>::type_digits)
+  >;
+  value = low_digits<digits>(value, Narrow());
+
+  // sign position (if any) is the first one
+  Iterator digits_begin = sink + (is_signed ? 1 : 0);
+
+  // 20+ digits of 128-bit type: only the widest one (39 digits)
+  using Wide = typename std::conditional<
+      (digits < 20), uint64_t, typename WideUnsigned<Unsigned>::type
+  >::type;
+  write_fixed<digits>(digits_begin, static_cast<Wide>(value));
+
+  if (pad == '0') {
+    if (is_signed) {
+      *sink = negative ? '-' : '0';
+    }
+    sink += width;
+    return;
+  }
+
+  if (is_signed) {
+    *sink = '0'; // will be replaced by pad
+  }
+
+  // Replace leading zeros (except the last digit), sign goes before
+  // the first significant digit. Fixed number of steps, no branches.
+  bool significant = false;
+  size_t leading = 0;
+  for (size_t i = 0; i < width - 1; ++i) {
+    significant = significant || (sink[i] != '0');
+    leading += significant ? 0 : 1;
+    sink[i] = significant ? sink[i] : pad;
+  }
+
+  if (is_signed) {
+    // value fits into `digits`, i.e. at least sign position is a pad
+    assert(leading > 0);
+    sink[leading - 1] = negative ? '-' : pad;
+  }
+
+  sink += width;
+}
+
+} // namespace padded
+
+#endif // ALGOS_PADDED_HPP_
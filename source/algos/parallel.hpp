@@ -0,0 +1,267 @@
+#ifndef ALGOS_PARALLEL_HPP_
+#define ALGOS_PARALLEL_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <algorithm> // std::min
+#include <cassert> // assert
+#include <condition_variable>
+#include <map>
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "counting.hpp"
+#include "Separator.hpp"
+#include "twopass.hpp"
+
+// Multi-threaded conversion of one vector:
+// 1) every thread count output length of its chunk (division free)
+// 2) wait for all threads, offset of chunk is sum of previous lengths
+// 3) every thread write its chunk directly to the final position
+// Threads of a persistent pool (see `Workers`).
+namespace parallel {
+
+using Iterator = char*;
+
+// Chunk with less values is not worth a thread
+enum {
+  MIN_CHUNK = 1024
+};
+
+inline unsigned default_threads() {
+  const unsigned result = std::thread::hardware_concurrency();
+  if (result == 0) {
+    // not computable
+    return 1;
+  }
+  return result;
+}
+
+class Barrier {
+ public:
+  explicit Barrier(unsigned count): count_(count) {
+  }
+
+  Barrier(const Barrier&) = delete;
+  Barrier& operator=(const Barrier&) = delete;
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    assert(count_ > 0);
+    --count_;
+    if (count_ == 0) {
+      condition_.notify_all();
+      return;
+    }
+    condition_.wait(lock, [this]() { return count_ == 0; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  unsigned count_;
+};
+
+// Threads reused by all calls of `generate` with the same number of
+// threads: created once (inherit affinity of the creating thread), wait
+// for the next task between calls. Timed runs measure the split, not
+// thread creation.
+class Workers {
+ public:
+  // `threads - 1` workers (current thread is the first one), less if
+  // thread can't be created
+  explicit Workers(unsigned threads):
+      call_(nullptr),
+      task_(nullptr),
+      generation_(0),
+      pending_(0),
+      stop_(false) {
+    assert(threads > 0);
+    workers_.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i) {
+      try {
+        workers_.emplace_back(&Workers::work, this, i);
+      }
+      catch (const std::system_error&) {
+        // run with started ones
+        break;
+      }
+    }
+  }
+
+  ~Workers() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& i: workers_) {
+      i.join();
+    }
+  }
+
+  Workers(const Workers&) = delete;
+  Workers& operator=(const Workers&) = delete;
+
+  unsigned threads() const {
+    return static_cast<unsigned>(workers_.size()) + 1;
+  }
+
+  // `task(index)` for every index of `[0, threads())`, index 0 called by
+  // current thread. Return when all calls finished.
+  template <class Task>
+  void run(Task& task) {
+    // one caller at a time
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      call_ = [](void* context, unsigned index) {
+        (*static_cast<Task*>(context))(index);
+      };
+      task_ = &task;
+      pending_ = workers_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return pending_ == 0; });
+  }
+
+ private:
+  using Call = void (*)(void*, unsigned);
+
+  void work(unsigned index) {
+    size_t generation = 0;
+    while (true) {
+      Call call;
+      void* task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [this, generation]() {
+          return stop_ || generation_ != generation;
+        });
+        if (stop_) {
+          return;
+        }
+        generation = generation_;
+        call = call_;
+        task = task_;
+      }
+
+      call(task, index);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pending_;
+      if (pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::mutex run_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  Call call_;
+  void* task_;
+  size_t generation_; // incremented by every `run`
+  size_t pending_; // workers not finished current task
+  bool stop_;
+
+  std::vector<std::thread> workers_;
+};
+
+// Workers for `threads` threads, created by the first call
+inline Workers& workers(unsigned threads) {
+  static std::mutex mutex;
+  static std::map<unsigned, std::unique_ptr<Workers>> pools;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<Workers>& result = pools[threads];
+  if (!result) {
+    result.reset(new Workers(threads));
+  }
+  return *result;
+}
+
+// Convert all values of `in` to `buffer` using `threads` threads
+// (including current, see `Workers`). `Separator` written after every
+// value, return number of bytes without the last separator
+// (no terminating '\0').
+template <class Separator = separator::None, class Vector>
+inline size_t generate(Iterator buffer, const Vector& in, unsigned threads) {
+  const size_t size = in.size();
+  const size_t max_threads = size / MIN_CHUNK;
+  if (max_threads < threads) {
+    threads = static_cast<unsigned>(max_threads);
+  }
+
+  Workers* pool = nullptr;
+  if (threads > 1) {
+    pool = &workers(threads);
+
+    // not all threads started
+    threads = pool->threads();
+  }
+
+  if (threads <= 1) {
+    Iterator sink = buffer;
+    for (auto& i: in) {
+      counting::generate(sink, i);
+      Separator::write(sink);
+    }
+    if (!in.empty()) {
+      sink -= Separator::size;
+    }
+    return static_cast<size_t>(sink - buffer);
+  }
+
+  std::vector<size_t> lengths(threads);
+  Barrier barrier(threads);
+
+  auto worker = [&](unsigned index) {
+    const size_t begin = size * index / threads;
+    const size_t end = size * (index + 1) / threads;
+
+    size_t length = 0;
+    for (size_t i = begin; i < end; ++i) {
+      length += twopass::length(in[i]) + Separator::size;
+    }
+    lengths[index] = length;
+
+    barrier.wait();
+
+    size_t offset = 0;
+    for (unsigned i = 0; i < index; ++i) {
+      offset += lengths[i];
+    }
+
+    Iterator sink = buffer + offset;
+    for (size_t i = begin; i < end; ++i) {
+      counting::generate(sink, in[i]);
+      Separator::write(sink);
+    }
+    assert(sink == buffer + offset + length);
+  };
+
+  // current thread process first chunk
+  pool->run(worker);
+
+  size_t total = 0;
+  for (auto i: lengths) {
+    total += i;
+  }
+  return total - Separator::size;
+}
+
+} // namespace parallel
+
+#endif // ALGOS_PARALLEL_HPP_
@@ -0,0 +1,327 @@
+#ifndef ALGOS_RADIX_HPP_
+#define ALGOS_RADIX_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstdint> // uint64_t
+#include <type_traits> // std::make_unsigned
+
+#include "CountDigitsLzcnt.hpp"
+#include "Int128.hpp"
+#include "Separator.hpp"
+#include "simd.hpp" // ALGOS_SIMD_TARGET, shift_left
+
+// Hexadecimal (lower/upper case) and octal output, no prefix. Signed values
+// are written as their unsigned counterparts (two's complement, as
+// `printf("%x")`). No division: number of digits from count leading zeros
+// (`(bits + 3) / 4`, `(bits + 2) / 3`), digits by shifts:
+//   * scalar: 2 digits per step from table of pairs
+//   * vector: hex - 16 nibbles to chars by one byte shuffle (SSSE3),
+//     octal - 8 digits per 24-bit chunk by multiply-shift in 32-bit
+//     lanes (SSE4.1). Selected at runtime (see simd.hpp), last values
+//     are converted by scalar code.
+namespace radix {
+
+using Iterator = char*;
+
+template <bool upper>
+class Hex {
+ public:
+  static const int bits = 4;
+
+  static char digit(unsigned value) {
+    return (upper ? "0123456789ABCDEF" : "0123456789abcdef")[value];
+  }
+};
+
+class Octal {
+ public:
+  static const int bits = 3;
+
+  static char digit(unsigned value) {
+    return static_cast<char>('0' + value);
+  }
+};
+
+// Two digits for every `2 * Radix::bits` bits
+template <class Radix>
+class Pairs {
+ public:
+  Pairs() {
+    const unsigned mask = (1u << Radix::bits) - 1;
+    for (unsigned i = 0; i < SIZE; ++i) {
+      data[2 * i] = Radix::digit(i >> Radix::bits);
+      data[2 * i + 1] = Radix::digit(i & mask);
+    }
+  }
+
+  enum {
+    SIZE = 1u << (2 * Radix::bits)
+  };
+
+  char data[2 * SIZE];
+};
+
+template <class Radix>
+inline const char* pairs() {
+  static const Pairs<Radix> result;
+  return result.data;
+}
+
+template <class Radix, class Unsigned>
+inline size_t count_digits(Unsigned value) {
+  static_assert(sizeof(Unsigned) <= sizeof(uint64_t), "");
+  const int bits = CountDigitsLzcnt::bits(static_cast<uint64_t>(value) | 1);
+  return static_cast<size_t>((bits + Radix::bits - 1) / Radix::bits);
+}
+
+#if HAVE_INT128
+template <class Radix>
+inline size_t count_digits(uint128_t value) {
+  const uint64_t high = static_cast<uint64_t>(value >> 64);
+  const int bits = (high != 0) ?
+      64 + CountDigitsLzcnt::bits(high) :
+      CountDigitsLzcnt::bits(static_cast<uint64_t>(value) | 1);
+  return static_cast<size_t>((bits + Radix::bits - 1) / Radix::bits);
+}
+#endif
+
+// Exactly `digits` digits "from the end", `sink` points to the position
+// after the last digit
+template <class Radix, class Unsigned>
+inline void fill(Iterator sink, Unsigned value, size_t digits, const char* pairs) {
+  const unsigned mask = (1u << (2 * Radix::bits)) - 1;
+
+  for (; digits >= 2; digits -= 2) {
+    const size_t index = static_cast<size_t>(value & mask) * 2;
+    value >>= 2 * Radix::bits;
+
+    --sink;
+    *sink = pairs[index + 1];
+
+    --sink;
+    *sink = pairs[index];
+  }
+
+  if (digits != 0) {
+    // pair "0d"
+    --sink;
+    *sink = pairs[static_cast<size_t>(value) * 2 + 1];
+  }
+}
+
+// One value by scalar code, `pairs` from `pairs<Radix>()`
+template <class Radix, class Integer>
+inline void convert(Iterator& sink, Integer input_value, const char* pairs) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  const Unsigned value(input_value);
+
+  const size_t digits = count_digits<Radix>(value);
+  sink += digits;
+  fill<Radix>(sink, value, digits, pairs);
+}
+
+#if ALGOS_SIMD_X86
+
+// Vector stores may write up to 15 bytes after the end of the number
+// (see simd::SCALAR_TAIL)
+enum {
+  SCALAR_TAIL = 16
+};
+
+// 16 hex digits of value, most significant first
+template <bool upper>
+ALGOS_SIMD_TARGET
+inline __m128i hex_16_digits(uint64_t value) {
+  const __m128i x = _mm_set_epi64x(0, static_cast<long long>(value));
+
+  // bytes of value most significant first
+  const __m128i bytes = _mm_shuffle_epi8(
+      x, _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, -1, -1, -1, -1, -1, -1, -1, -1)
+  );
+
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+  const __m128i low = _mm_and_si128(bytes, mask);
+  const __m128i nibbles = _mm_unpacklo_epi8(high, low);
+
+  const __m128i table = upper ?
+      _mm_setr_epi8(
+          '0', '1', '2', '3', '4', '5', '6', '7',
+          '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+      ) :
+      _mm_setr_epi8(
+          '0', '1', '2', '3', '4', '5', '6', '7',
+          '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+      );
+  return _mm_shuffle_epi8(table, nibbles);
+}
+
+template <bool upper>
+ALGOS_SIMD_TARGET
+inline void generate_unsigned(Hex<upper>, Iterator& sink, uint64_t value) {
+  const size_t digits = count_digits<Hex<upper>>(value);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(sink),
+      simd::shift_left(hex_16_digits<upper>(value), 16 - digits)
+  );
+  sink += digits;
+}
+
+#if HAVE_INT128
+// High 64 bits, then exactly 16 digits
+template <bool upper>
+ALGOS_SIMD_TARGET
+inline void generate_unsigned(Hex<upper> radix, Iterator& sink, uint128_t value) {
+  const uint64_t high = static_cast<uint64_t>(value >> 64);
+  if (high == 0) {
+    generate_unsigned(radix, sink, static_cast<uint64_t>(value));
+    return;
+  }
+  generate_unsigned(radix, sink, high);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(sink),
+      hex_16_digits<upper>(static_cast<uint64_t>(value))
+  );
+  sink += 16;
+}
+#endif
+
+// 8 octal digits of 24-bit chunk (16-bit lanes, most significant first):
+// digit `i` is `(chunk >> (21 - 3 * i)) & 7`, variable shift replaced by
+// mask, multiply by `2^(3 * i)` and shift by 21
+ALGOS_SIMD_TARGET
+inline __m128i octal_8_digits(uint32_t chunk) {
+  const __m128i value = _mm_set1_epi32(static_cast<int>(chunk));
+
+  const __m128i high = _mm_srli_epi32(
+      _mm_mullo_epi32(
+          _mm_and_si128(value, _mm_setr_epi32(7 << 21, 7 << 18, 7 << 15, 7 << 12)),
+          _mm_setr_epi32(1, 1 << 3, 1 << 6, 1 << 9)
+      ),
+      21
+  );
+  const __m128i low = _mm_srli_epi32(
+      _mm_mullo_epi32(
+          _mm_and_si128(value, _mm_setr_epi32(7 << 9, 7 << 6, 7 << 3, 7)),
+          _mm_setr_epi32(1 << 12, 1 << 15, 1 << 18, 1 << 21)
+      ),
+      21
+  );
+  return _mm_packus_epi32(high, low);
+}
+
+ALGOS_SIMD_TARGET
+inline void generate_unsigned(Octal, Iterator& sink, uint64_t value) {
+  const uint32_t chunk_mask = (1u << 24) - 1;
+
+  if (value < (1ull << 24)) {
+    // 1..8 digits, 8 bytes stored
+    const size_t digits = count_digits<Octal>(value);
+    const __m128i chars = simd::shift_left(
+        simd::to_ascii(
+            octal_8_digits(static_cast<uint32_t>(value)), _mm_setzero_si128()
+        ),
+        8 - digits
+    );
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(sink), chars);
+    sink += digits;
+    return;
+  }
+
+  const uint32_t low = static_cast<uint32_t>(value) & chunk_mask;
+
+  if (value < (1ull << 48)) {
+    // 9..16 digits, 16 bytes stored
+    const size_t digits = count_digits<Octal>(value);
+    const uint32_t high = static_cast<uint32_t>(value >> 24);
+    const __m128i chars = simd::shift_left(
+        simd::to_ascii(octal_8_digits(high), octal_8_digits(low)), 16 - digits
+    );
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sink), chars);
+    sink += digits;
+    return;
+  }
+
+  // 17..22 digits: 1..6 leading digits, 16 digits exactly
+  generate_unsigned(Octal(), sink, value >> 48);
+
+  const uint32_t middle = static_cast<uint32_t>(value >> 24) & chunk_mask;
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(sink),
+      simd::to_ascii(octal_8_digits(middle), octal_8_digits(low))
+  );
+  sink += 16;
+}
+
+#if HAVE_INT128
+// Leading digits of `value >> 48`, then exactly 16 digits
+ALGOS_SIMD_TARGET
+inline void generate_unsigned(Octal radix, Iterator& sink, uint128_t value) {
+  if (int128::fits_64(value)) {
+    generate_unsigned(radix, sink, static_cast<uint64_t>(value));
+    return;
+  }
+
+  generate_unsigned(radix, sink, value >> 48);
+
+  const uint32_t chunk_mask = (1u << 24) - 1;
+  const uint32_t middle = static_cast<uint32_t>(value >> 24) & chunk_mask;
+  const uint32_t low = static_cast<uint32_t>(value) & chunk_mask;
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(sink),
+      simd::to_ascii(octal_8_digits(middle), octal_8_digits(low))
+  );
+  sink += 16;
+}
+#endif
+
+template <class Radix, class Integer>
+ALGOS_SIMD_TARGET
+inline void generate_vector(Iterator& sink, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  using Wide = typename WideUnsigned<Unsigned>::type;
+  generate_unsigned(Radix(), sink, static_cast<Wide>(Unsigned(input_value)));
+}
+
+#endif // ALGOS_SIMD_X86
+
+// Convert all values of `in` to `sink` by scalar code, `Separator`
+// written after every value (no terminating '\0')
+template <class Radix, class Separator = separator::None, class Vector>
+inline void generate(Iterator& sink, const Vector& in) {
+  const char* table = pairs<Radix>();
+  for (auto& i: in) {
+    convert<Radix>(sink, i, table);
+    Separator::write(sink);
+  }
+}
+
+// Same with vector code if supported
+template <class Radix, class Separator = separator::None, class Vector>
+inline void generate_simd(Iterator& sink, const Vector& in) {
+  const size_t size = in.size();
+  size_t i = 0;
+
+#if ALGOS_SIMD_X86
+  if (simd::enabled() && size > SCALAR_TAIL) {
+    const size_t vector_size = size - SCALAR_TAIL;
+    for (; i < vector_size; ++i) {
+      generate_vector<Radix>(sink, in[i]);
+      Separator::write(sink);
+    }
+  }
+#endif
+
+  // scalar tail
+  const char* table = pairs<Radix>();
+  for (; i < size; ++i) {
+    convert<Radix>(sink, in[i], table);
+    Separator::write(sink);
+  }
+}
+
+} // namespace radix
+
+#endif // ALGOS_RADIX_HPP_
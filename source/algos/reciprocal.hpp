@@ -0,0 +1,226 @@
+#ifndef ALGOS_RECIPROCAL_HPP_
+#define ALGOS_RECIPROCAL_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint64_t
+#include <type_traits> // std::make_unsigned
+
+#include "CountDigits.hpp"
+#include "Int128.hpp"
+
+// Division free digits emission (jeaiii/Lemire style):
+// value < 10^8 multiplied by fixed-point reciprocal of 10^(2k),
+// integer part of result is the leading digits, next pairs extracted
+// by `fraction * 100` (shift/mask only, no `% 100` and `/ 100`).
+// Values with more than 8 digits split into 8-digit chunks
+// (division by constant, once per chunk).
+namespace reciprocal {
+
+using Iterator = char*;
+
+inline const char* cache_digits() {
+  return
+      "00010203040506070809"
+      "10111213141516171819"
+      "20212223242526272829"
+      "30313233343536373839"
+      "40414243444546474849"
+      "50515253545556575859"
+      "60616263646566676869"
+      "70717273747576777879"
+      "80818283848586878889"
+      "90919293949596979899"
+  ;
+}
+
+// Fixed-point with 48 fraction bits:
+//   * 10^8 * 2^48 / 10^6 < 2^64, i.e. no overflow
+//   * reciprocal rounded up, error for value < 10^8 is less than 10^-7,
+//     i.e. next 6 digits extracted exactly
+enum {
+  FRACTION_BITS = 48
+};
+
+const uint64_t FRACTION_MASK = (uint64_t(1) << FRACTION_BITS) - 1;
+
+// ceil(2^48 / 10^(2 * pairs))
+inline uint64_t reciprocal(size_t pairs) {
+  static const uint64_t table[] = {
+      uint64_t(1) << FRACTION_BITS,
+      2814749767107ull,
+      28147497672ull,
+      281474977ull
+  };
+  assert(pairs < 4);
+  return table[pairs];
+}
+
+inline void write_pair(Iterator sink, uint64_t fixed) {
+  const size_t index = static_cast<size_t>(fixed >> FRACTION_BITS) * 2;
+  const char* cache = cache_digits();
+  sink[0] = cache[index];
+  sink[1] = cache[index + 1];
+}
+
+inline uint64_t next_pair(uint64_t fixed) {
+  return (fixed & FRACTION_MASK) * 100;
+}
+
+// Write exactly 8 digits (with leading zeros) of value < 10^8
+inline void write_8_digits(Iterator sink, uint32_t value) {
+  assert(value < Power10<8>::value);
+
+  uint64_t fixed = value * reciprocal(3);
+  write_pair(sink, fixed);
+
+  fixed = next_pair(fixed);
+  write_pair(sink + 2, fixed);
+
+  fixed = next_pair(fixed);
+  write_pair(sink + 4, fixed);
+
+  fixed = next_pair(fixed);
+  write_pair(sink + 6, fixed);
+}
+
+// Write exactly `digits` digits (with leading zeros) of value < 10^digits
+inline void write_digits(Iterator sink, uint32_t value, size_t digits) {
+  assert(digits > 0);
+  assert(digits <= 8);
+
+  const size_t pairs = (digits - 1) / 2;
+
+  uint64_t fixed = value * reciprocal(pairs);
+
+  if (digits % 2 == 1) {
+    // 0..9
+    *sink = static_cast<char>('0' + (fixed >> FRACTION_BITS));
+    ++sink;
+  }
+  else {
+    // 0..99
+    write_pair(sink, fixed);
+    sink += 2;
+  }
+
+  for (size_t i = 0; i < pairs; ++i) {
+    fixed = next_pair(fixed);
+    write_pair(sink, fixed);
+    sink += 2;
+  }
+}
+
+// Write value < 10^8 without leading zeros
+inline void write_head(Iterator& sink, uint32_t value) {
+  assert(value < Power10<8>::value);
+
+  const size_t digits = CountDigits<7>::template count<1, 7>(value);
+  write_digits(sink, value, digits);
+  sink += digits;
+}
+
+template <int bits>
+class Generator;
+
+template <>
+class Generator<32> {
+ public:
+  static void generate(Iterator& sink, uint32_t value) {
+    if (value < Power10<8>::value) {
+      write_head(sink, value);
+      return;
+    }
+
+    // 9..10 digits
+    write_head(sink, value / static_cast<uint32_t>(Power10<8>::value));
+    write_8_digits(sink, value % static_cast<uint32_t>(Power10<8>::value));
+    sink += 8;
+  }
+};
+
+template <>
+class Generator<64> {
+ public:
+  static void generate(Iterator& sink, uint64_t value) {
+    if (value < Power10<8>::value) {
+      write_head(sink, static_cast<uint32_t>(value));
+      return;
+    }
+
+    if (value < Power10<16>::value) {
+      // 9..16 digits
+      write_head(sink, static_cast<uint32_t>(value / Power10<8>::value));
+      write_8_digits(sink, static_cast<uint32_t>(value % Power10<8>::value));
+      sink += 8;
+      return;
+    }
+
+    // 17..20 digits
+    const uint64_t rest = value % Power10<16>::value;
+    write_head(sink, static_cast<uint32_t>(value / Power10<16>::value));
+    write_8_digits(sink, static_cast<uint32_t>(rest / Power10<8>::value));
+    write_8_digits(sink + 8, static_cast<uint32_t>(rest % Power10<8>::value));
+    sink += 16;
+  }
+};
+
+#if HAVE_INT128
+// Write exactly 19 digits (with leading zeros) of value < 10^19
+inline void write_19_digits(Iterator& sink, uint64_t value) {
+  const uint64_t rest = value % Power10<16>::value;
+  write_digits(sink, static_cast<uint32_t>(value / Power10<16>::value), 3);
+  write_8_digits(sink + 3, static_cast<uint32_t>(rest / Power10<8>::value));
+  write_8_digits(sink + 11, static_cast<uint32_t>(rest % Power10<8>::value));
+  sink += 19;
+}
+
+template <>
+class Generator<128> {
+ public:
+  static void generate(Iterator& sink, uint128_t value) {
+    if (int128::fits_64(value)) {
+      Generator<64>::generate(sink, static_cast<uint64_t>(value));
+      return;
+    }
+
+    // 21..39 digits: 64-bit head, 19-digit chunks
+    uint64_t low;
+    value = int128::divide_10_19(value, low);
+
+    if (int128::fits_64(value)) {
+      Generator<64>::generate(sink, static_cast<uint64_t>(value));
+    }
+    else {
+      uint64_t middle;
+      value = int128::divide_10_19(value, middle);
+      Generator<64>::generate(sink, static_cast<uint64_t>(value));
+      write_19_digits(sink, middle);
+    }
+
+    write_19_digits(sink, low);
+  }
+};
+#endif
+
+template <class Integer>
+inline void generate(Iterator& sink, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+
+  static const int bits =
+      (sizeof(Unsigned) > 8) ? 128 : (sizeof(Unsigned) > 4) ? 64 : 32;
+  Generator<bits>::generate(sink, value);
+}
+
+} // namespace reciprocal
+
+#endif // ALGOS_RECIPROCAL_HPP_
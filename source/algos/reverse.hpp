@@ -6,6 +6,10 @@
 
 #include <cassert> // assert
 #include <algorithm> // std::reverse
+#include <cstdint> // uint64_t
+#include <type_traits> // std::make_unsigned
+
+#include "Int128.hpp"
 
 namespace reverse {
 
@@ -26,26 +30,11 @@ inline const char* cache_digits() {
 
 using Iterator = char*;
 
-// 1) fill buffer
-// 2) reverse in-situ
-template <class Integer>
-inline void generate(Iterator& sink_out, Integer input_value) {
-  using Unsigned = typename std::make_unsigned<Integer>::type;
-  Unsigned value(input_value);
-
-  Iterator sink = sink_out;
-
-  if (input_value < 0) {
-    *sink = '-';
-    ++sink;
-    value = 0 - value;
-  }
-
-  assert(value >= 0); // sanity check
+// Fill digits in reverse order (least significant first)
+template <class Unsigned>
+inline void fill_reversed(Iterator& sink, Unsigned value) {
   const char* cache = cache_digits();
 
-  Iterator reverse_start = sink;
-
   while (value >= 100) {
     size_t index = (value % 100) * 2; // 0..198
     value /= 100;
@@ -74,7 +63,56 @@ inline void generate(Iterator& sink_out, Integer input_value) {
     *sink = cache[index];
     ++sink;
   }
+}
+
+#if HAVE_INT128
+// Parts of `int128::divide_10_19`, every part exactly 19 digits
+// (least significant first: `int128::fill_19` order doesn't fit)
+inline void fill_reversed(Iterator& sink, uint128_t value) {
+  const char* cache = cache_digits();
+
+  while (!int128::fits_64(value)) {
+    uint64_t low;
+    value = int128::divide_10_19(value, low);
+
+    // exactly 19 digits with leading zeros
+    for (int i = 0; i < 9; ++i) {
+      size_t index = static_cast<size_t>(low % 100) * 2; // 0..198
+      low /= 100;
+
+      *sink = cache[index + 1];
+      ++sink;
+
+      *sink = cache[index];
+      ++sink;
+    }
+    *sink = static_cast<char>('0' + low);
+    ++sink;
+  }
+
+  fill_reversed(sink, static_cast<uint64_t>(value));
+}
+#endif
+
+// 1) fill buffer
+// 2) reverse in-situ
+template <class Integer>
+inline void generate(Iterator& sink_out, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  Iterator sink = sink_out;
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
 
+  assert(value >= 0); // sanity check
+
+  Iterator reverse_start = sink;
+  fill_reversed(sink, value);
   std::reverse(reverse_start, sink);
 
   sink_out = sink;
@@ -0,0 +1,271 @@
+#ifndef ALGOS_SIMD_HPP_
+#define ALGOS_SIMD_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint64_t
+#include <type_traits> // std::make_unsigned
+
+#include "CountDigits.hpp"
+#include "Int128.hpp"
+#include "Separator.hpp"
+#include "counting.hpp"
+
+// Batch formatter: 8/16 digits are converted at once with SSE4.1
+// multiply-shift instead of `% 100` / `/ 100` loop
+// (based on SSE2 itoa by Wojciech Mula, see also itoa-benchmark by Milo Yip).
+// Vector code is selected at runtime, `counting` is used as fallback.
+
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86)
+# define ALGOS_SIMD_X86 1
+#else
+# define ALGOS_SIMD_X86 0
+#endif
+
+#if ALGOS_SIMD_X86
+# include <smmintrin.h> // SSE4.1
+# if defined(_MSC_VER)
+#  include <intrin.h> // __cpuid
+#  define ALGOS_SIMD_TARGET
+# else
+#  define ALGOS_SIMD_TARGET __attribute__((target("sse4.1")))
+# endif
+#endif
+
+namespace simd {
+
+using Iterator = char*;
+
+// Vector stores may write up to 7 bytes after the end of the number.
+// These bytes are overwritten by the next values (each value is at least
+// 1 char) or by the terminating '\0', so last values are always converted
+// by scalar code.
+enum {
+  SCALAR_TAIL = 8
+};
+
+inline bool cpu_supported() {
+#if !ALGOS_SIMD_X86
+  return false;
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 19)) != 0; // ECX.SSE4_1
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+// cpuid called once
+inline bool enabled() {
+  static const bool result = cpu_supported();
+  return result;
+}
+
+#if ALGOS_SIMD_X86
+
+// Convert value 0..99999999 to 8 digits (16-bit lanes, most significant first)
+ALGOS_SIMD_TARGET
+inline __m128i convert_8_digits(uint32_t value) {
+  assert(value <= 99999999);
+
+  // abcd = abcdefgh / 10000, efgh = abcdefgh % 10000
+  const __m128i abcdefgh = _mm_cvtsi32_si128(static_cast<int>(value));
+  const __m128i abcd = _mm_srli_epi64(
+      _mm_mul_epu32(abcdefgh, _mm_set1_epi32(static_cast<int>(0xd1b71759))),
+      45
+  );
+  const __m128i efgh = _mm_sub_epi32(
+      abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10000))
+  );
+
+  // [ abcd, efgh, 0, 0, 0, 0, 0, 0 ]
+  const __m128i v1 = _mm_unpacklo_epi16(abcd, efgh);
+
+  // [ abcd * 4, abcd * 4, abcd * 4, abcd * 4, efgh * 4, ... ]
+  const __m128i v1a = _mm_slli_epi64(v1, 2);
+  const __m128i v2a = _mm_unpacklo_epi16(v1a, v1a);
+  const __m128i v2 = _mm_unpacklo_epi32(v2a, v2a);
+
+  // Divide by 10^3, 10^2, 10^1, 10^0 using multiply-shift:
+  // [ a, ab, abc, abcd, e, ef, efg, efgh ]
+  const __m128i v3 = _mm_mulhi_epu16(
+      v2, _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768)
+  );
+  const __m128i v4 = _mm_mulhi_epu16(
+      v3,
+      _mm_setr_epi16(
+          1 << (16 - (23 + 2 - 16)),
+          1 << (16 - (19 + 2 - 16)),
+          1 << (16 - 1 - 2),
+          -32768, // 1 << 15
+          1 << (16 - (23 + 2 - 16)),
+          1 << (16 - (19 + 2 - 16)),
+          1 << (16 - 1 - 2),
+          -32768 // 1 << 15
+      )
+  );
+
+  // [ 0, a0, ab0, abc0, 0, e0, ef0, efg0 ]
+  const __m128i v5 = _mm_mullo_epi16(v4, _mm_set1_epi16(10));
+  const __m128i v6 = _mm_slli_epi64(v5, 16);
+
+  // [ a, b, c, d, e, f, g, h ]
+  return _mm_sub_epi16(v4, v6);
+}
+
+// Move byte `i + shift` to position `i` (skip leading zeros)
+ALGOS_SIMD_TARGET
+inline __m128i shift_left(__m128i chars, size_t shift) {
+  assert(shift < 16);
+  const __m128i index = _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(shift))
+  );
+  return _mm_shuffle_epi8(chars, index);
+}
+
+ALGOS_SIMD_TARGET
+inline __m128i to_ascii(__m128i high, __m128i low) {
+  return _mm_add_epi8(_mm_packus_epi16(high, low), _mm_set1_epi8('0'));
+}
+
+ALGOS_SIMD_TARGET
+inline void generate_unsigned(Iterator& sink, uint64_t value) {
+  if (value < Power10<4>::value) {
+    // 1..4 digits, nothing to vectorize
+    counting::generate(sink, static_cast<uint32_t>(value));
+    return;
+  }
+
+  if (value < Power10<8>::value) {
+    // 5..8 digits, 8 bytes stored
+    const size_t digits = CountDigits<3>::template count<5, 7>(value);
+    const __m128i chars = shift_left(
+        to_ascii(convert_8_digits(static_cast<uint32_t>(value)), _mm_setzero_si128()),
+        8 - digits
+    );
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(sink), chars);
+    sink += digits;
+    return;
+  }
+
+  if (value < Power10<16>::value) {
+    // 9..16 digits, 16 bytes stored
+    const size_t digits = CountDigits<7>::template count<9, 15>(value);
+    const uint32_t high = static_cast<uint32_t>(value / Power10<8>::value);
+    const uint32_t low = static_cast<uint32_t>(value % Power10<8>::value);
+    const __m128i chars = shift_left(
+        to_ascii(convert_8_digits(high), convert_8_digits(low)), 16 - digits
+    );
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sink), chars);
+    sink += digits;
+    return;
+  }
+
+  // 17..20 digits: 1..4 leading digits by scalar code, 16 digits exactly
+  const uint64_t rest = value % Power10<16>::value;
+  counting::generate(sink, static_cast<uint32_t>(value / Power10<16>::value));
+
+  const uint32_t high = static_cast<uint32_t>(rest / Power10<8>::value);
+  const uint32_t low = static_cast<uint32_t>(rest % Power10<8>::value);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(sink),
+      to_ascii(convert_8_digits(high), convert_8_digits(low))
+  );
+  sink += 16;
+}
+
+#if HAVE_INT128
+// Exactly 19 digits: 3 leading digits by scalar code, 16 digits at once
+ALGOS_SIMD_TARGET
+inline void generate_19_digits(Iterator& sink, uint64_t value) {
+  const uint64_t rest = value % Power10<16>::value;
+  const size_t head = static_cast<size_t>(value / Power10<16>::value);
+  sink[0] = static_cast<char>('0' + head / 100);
+  sink[1] = static_cast<char>('0' + head / 10 % 10);
+  sink[2] = static_cast<char>('0' + head % 10);
+  sink += 3;
+
+  const uint32_t high = static_cast<uint32_t>(rest / Power10<8>::value);
+  const uint32_t low = static_cast<uint32_t>(rest % Power10<8>::value);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(sink),
+      to_ascii(convert_8_digits(high), convert_8_digits(low))
+  );
+  sink += 16;
+}
+
+// 21..39 digits: 64-bit head, 19-digit chunks
+ALGOS_SIMD_TARGET
+inline void generate_unsigned(Iterator& sink, uint128_t value) {
+  if (int128::fits_64(value)) {
+    generate_unsigned(sink, static_cast<uint64_t>(value));
+    return;
+  }
+
+  uint64_t low;
+  uint64_t middle = 0;
+  value = int128::divide_10_19(value, low);
+  const bool has_middle = !int128::fits_64(value);
+  if (has_middle) {
+    value = int128::divide_10_19(value, middle);
+  }
+
+  generate_unsigned(sink, static_cast<uint64_t>(value));
+  if (has_middle) {
+    generate_19_digits(sink, middle);
+  }
+  generate_19_digits(sink, low);
+}
+#endif
+
+template <class Integer>
+ALGOS_SIMD_TARGET
+inline void generate_vector(Iterator& sink, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+
+  using Wide = typename WideUnsigned<Unsigned>::type;
+  generate_unsigned(sink, static_cast<Wide>(value));
+}
+
+#endif // ALGOS_SIMD_X86
+
+// Convert all values of `in` to `sink`, `Separator` written after
+// every value (no terminating '\0')
+template <class Separator = separator::None, class Vector>
+inline void generate(Iterator& sink, const Vector& in) {
+  const size_t size = in.size();
+  size_t i = 0;
+
+#if ALGOS_SIMD_X86
+  if (enabled() && size > SCALAR_TAIL) {
+    const size_t vector_size = size - SCALAR_TAIL;
+    for (; i < vector_size; ++i) {
+      generate_vector(sink, in[i]);
+      Separator::write(sink);
+    }
+  }
+#endif
+
+  // scalar tail
+  for (; i < size; ++i) {
+    counting::generate(sink, in[i]);
+    Separator::write(sink);
+  }
+}
+
+} // namespace simd
+
+#endif // ALGOS_SIMD_HPP_
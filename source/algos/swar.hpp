@@ -0,0 +1,203 @@
+#ifndef ALGOS_SWAR_HPP_
+#define ALGOS_SWAR_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint64_t
+#include <cstring> // std::memcpy
+#include <type_traits> // std::make_unsigned, std::conditional
+
+#include "CountDigits.hpp"
+#include "Int128.hpp"
+#include "Separator.hpp"
+#include "counting.hpp"
+
+// SIMD within a register, no SIMD instruction set required:
+// 4 digits converted in uint32_t, 8 digits in uint64_t by
+// multiply/shift/mask (split by 100 and by 10 in every lane at once,
+// see "Fast integer to string" by Paul Khuong), ASCII stored by one
+// 4/8-byte write. Division by 10^8 only once per 8 digits.
+namespace swar {
+
+using Iterator = char*;
+
+// Stores may write up to 7 bytes after the end of the number
+// (as in `simd`), last values are converted by `counting`.
+enum {
+  SCALAR_TAIL = 8
+};
+
+// value < 10^4 -> 4 chars, first char in the lowest byte
+inline uint32_t encode_4_digits(uint32_t value) {
+  assert(value < Power10<4>::value);
+
+  // 2 x 16-bit lanes: [value / 100, value % 100]
+  const uint32_t high = (value * 5243) >> 19; // value / 100
+  const uint32_t pairs = high | ((value - 100 * high) << 16);
+
+  // 4 x 8-bit lanes: [pair / 10, pair % 10]
+  const uint32_t tens = ((pairs * 103) >> 10) & 0x000F000F;
+  const uint32_t digits = tens | ((pairs - 10 * tens) << 8);
+
+  return digits + 0x30303030;
+}
+
+// value < 10^8 -> 8 chars, first char in the lowest byte
+inline uint64_t encode_8_digits(uint32_t value) {
+  assert(value < Power10<8>::value);
+
+  // 2 x 32-bit lanes: [value / 10^4, value % 10^4]
+  const uint32_t high = value / 10000;
+  const uint64_t quads = high | (uint64_t(value - 10000 * high) << 32);
+
+  // 4 x 16-bit lanes: [quad / 100, quad % 100]
+  const uint64_t hundreds =
+      ((quads * 10486) >> 20) & 0x0000007F0000007Full;
+  const uint64_t pairs = hundreds | ((quads - 100 * hundreds) << 16);
+
+  // 8 x 8-bit lanes: [pair / 10, pair % 10]
+  const uint64_t tens = ((pairs * 103) >> 10) & 0x000F000F000F000Full;
+  const uint64_t digits = tens | ((pairs - 10 * tens) << 8);
+
+  return digits + 0x3030303030303030ull;
+}
+
+// Chars in memory order (first char in the lowest byte)
+template <class Word>
+inline void store(Iterator sink, Word chars) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  for (size_t i = 0; i < sizeof(Word); ++i) {
+    sink[i] = static_cast<char>(chars >> (8 * i));
+  }
+#else
+  std::memcpy(sink, &chars, sizeof(Word)); // one unaligned store
+#endif
+}
+
+// value < 10^8 without leading zeros: leading zero chars shifted out
+inline void write_head(Iterator& sink, uint32_t value) {
+  if (value < Power10<4>::value) {
+    const size_t digits = CountDigits<3>::template count<1, 3>(value);
+    store(sink, encode_4_digits(value) >> (8 * (4 - digits)));
+    sink += digits;
+    return;
+  }
+
+  const size_t digits = CountDigits<3>::template count<5, 7>(value);
+  store(sink, encode_8_digits(value) >> (8 * (8 - digits)));
+  sink += digits;
+}
+
+inline void write_8_digits(Iterator& sink, uint32_t value) {
+  store(sink, encode_8_digits(value));
+  sink += 8;
+}
+
+// Division in `Unsigned`: no 64-bit division for 32-bit types
+// (library call on 32-bit targets)
+template <class Unsigned>
+inline void generate_unsigned(Iterator& sink, Unsigned value) {
+  const Unsigned p8 = static_cast<Unsigned>(Power10<8>::value);
+
+  if (value < p8) {
+    write_head(sink, static_cast<uint32_t>(value));
+    return;
+  }
+
+  const uint32_t low = static_cast<uint32_t>(value % p8);
+  value /= p8;
+
+  if (value < p8) {
+    // 9..16 digits
+    write_head(sink, static_cast<uint32_t>(value));
+    write_8_digits(sink, low);
+    return;
+  }
+
+  // 17..20 digits
+  write_head(sink, static_cast<uint32_t>(value / p8));
+  write_8_digits(sink, static_cast<uint32_t>(value % p8));
+  write_8_digits(sink, low);
+}
+
+#if HAVE_INT128
+// Exactly 19 digits: 3 + 8 + 8
+inline void write_19_digits(Iterator& sink, uint64_t value) {
+  const uint64_t p8 = Power10<8>::value;
+  const uint32_t low = static_cast<uint32_t>(value % p8);
+  value /= p8;
+
+  store(sink, encode_4_digits(static_cast<uint32_t>(value / p8)) >> 8);
+  sink += 3;
+  write_8_digits(sink, static_cast<uint32_t>(value % p8));
+  write_8_digits(sink, low);
+}
+
+// 128-bit value split into 64-bit parts
+inline void generate_unsigned(Iterator& sink, uint128_t value) {
+  if (int128::fits_64(value)) {
+    generate_unsigned(sink, static_cast<uint64_t>(value));
+    return;
+  }
+
+  uint64_t low;
+  uint64_t middle = 0;
+  value = int128::divide_10_19(value, low);
+  const bool has_middle = !int128::fits_64(value);
+  if (has_middle) {
+    value = int128::divide_10_19(value, middle);
+  }
+
+  generate_unsigned(sink, static_cast<uint64_t>(value));
+  if (has_middle) {
+    write_19_digits(sink, middle);
+  }
+  write_19_digits(sink, low);
+}
+#endif
+
+template <class Integer>
+inline void generate_value(Iterator& sink, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+
+  // 10^8 doesn't fit 16-bit type
+  using Promoted = typename std::conditional<
+      (sizeof(Unsigned) < sizeof(uint32_t)), uint32_t, Unsigned
+  >::type;
+  generate_unsigned(sink, static_cast<Promoted>(value));
+}
+
+// Convert all values of `in` to `sink`, `Separator` written after
+// every value (no terminating '\0')
+template <class Separator = separator::None, class Vector>
+inline void generate(Iterator& sink, const Vector& in) {
+  const size_t size = in.size();
+  size_t i = 0;
+
+  if (size > SCALAR_TAIL) {
+    const size_t swar_size = size - SCALAR_TAIL;
+    for (; i < swar_size; ++i) {
+      generate_value(sink, in[i]);
+      Separator::write(sink);
+    }
+  }
+
+  // scalar tail
+  for (; i < size; ++i) {
+    counting::generate(sink, in[i]);
+    Separator::write(sink);
+  }
+}
+
+} // namespace swar
+
+#endif // ALGOS_SWAR_HPP_
@@ -7,6 +7,10 @@
 #include <cassert> // assert
 #include <limits> // std::numeric_limits
 #include <array>
+#include <cstdint> // uint64_t
+#include <type_traits> // std::make_unsigned
+
+#include "Int128.hpp"
 
 // 1) fill temporary buffer "from the end"
 // 2) copy to destination
@@ -29,31 +33,11 @@ inline const char* cache_digits() {
   ;
 }
 
-template <class Integer>
-inline void generate(Iterator& sink_out, Integer input_value) {
-  using Unsigned = typename std::make_unsigned<Integer>::type;
-  Unsigned value(input_value);
-
-  Iterator sink = sink_out;
-
-  if (input_value < 0) {
-    *sink = '-';
-    ++sink;
-    value = 0 - value;
-  }
-
-  enum {
-    MAX_DIGITS = std::numeric_limits<Integer>::digits10 +
-        1 // round error
-  };
-
-  std::array<char, MAX_DIGITS> buffer;
-  char* buffer_end = buffer.data() + buffer.size();
-  char* it = buffer_end;
-
+// Fill digits "from the end", `it` moved to the first digit
+template <class Unsigned>
+inline void fill(Iterator& it, Unsigned value) {
   const char* cache = cache_digits();
 
-  assert(value >= 0);
   while (value >= 100) {
     size_t index = (value % 100) * 2; // 0..198
     value /= 100;
@@ -82,6 +66,46 @@ inline void generate(Iterator& sink_out, Integer input_value) {
     --it;
     *it = cache[index];
   }
+}
+
+#if HAVE_INT128
+// Low parts of 19 digits to the end of temporary buffer
+inline void fill(Iterator& it, uint128_t value) {
+  while (!int128::fits_64(value)) {
+    uint64_t low;
+    value = int128::divide_10_19(value, low);
+    int128::fill_19(it, low, cache_digits());
+    it -= 19;
+  }
+
+  fill(it, static_cast<uint64_t>(value));
+}
+#endif
+
+template <class Integer>
+inline void generate(Iterator& sink_out, Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  Iterator sink = sink_out;
+
+  if (input_value < 0) {
+    *sink = '-';
+    ++sink;
+    value = 0 - value;
+  }
+
+  enum {
+    MAX_DIGITS = std::numeric_limits<Integer>::digits10 +
+        1 // round error
+  };
+
+  std::array<char, MAX_DIGITS> buffer;
+  char* buffer_end = buffer.data() + buffer.size();
+  char* it = buffer_end;
+
+  assert(value >= 0);
+  fill(it, value);
 
   // std::copy implemented using memcpy call
   // there is no visible befinits on such small memory chunks
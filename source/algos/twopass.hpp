@@ -0,0 +1,106 @@
+#ifndef ALGOS_TWOPASS_HPP_
+#define ALGOS_TWOPASS_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <type_traits> // std::make_unsigned
+#include <vector>
+
+#include "counting.hpp"
+#include "Separator.hpp"
+
+// Batch conversion with exact output size:
+// 1) count length of every value, prefix sum give offsets and total size
+// 2) write every value directly to its final position "from the end"
+namespace twopass {
+
+using Iterator = char*;
+
+// offsets[i] - position of value `i`, offsets[size] - total size,
+// value `i` followed by separator if it's not the last one
+using Offsets = std::vector<size_t>;
+
+template <class Integer>
+inline size_t length(Integer input_value) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  Unsigned value(input_value);
+
+  if (input_value < 0) {
+    value = 0 - value;
+    return 1 + counting::count_digits(value);
+  }
+  return counting::count_digits(value);
+}
+
+// First pass. Return total size in bytes (without terminating '\0')
+template <class Separator = separator::None, class Vector>
+inline size_t count(const Vector& in, Offsets& offsets) {
+  offsets.resize(in.size() + 1);
+
+  size_t total = 0;
+  for (size_t i = 0; i < in.size(); ++i) {
+    offsets[i] = total;
+    total += length(in[i]) + Separator::size;
+  }
+
+  if (!in.empty()) {
+    // no separator after the last value
+    total -= Separator::size;
+  }
+  offsets[in.size()] = total;
+
+  return total;
+}
+
+template <class Unsigned, class Integer>
+inline void write_value(Iterator begin, Iterator end, Integer input_value) {
+  Unsigned value(input_value);
+
+  if (input_value < 0) {
+    *begin = '-';
+    value = 0 - value;
+  }
+
+  counting::fill(end, value);
+}
+
+// Second pass. `buffer` should have at least `offsets.back()` bytes
+template <class Separator = separator::None, class Vector>
+inline void write(Iterator buffer, const Vector& in, const Offsets& offsets) {
+  using Unsigned = typename std::make_unsigned<typename Vector::value_type>::type;
+
+  assert(offsets.size() == in.size() + 1);
+
+  if (in.empty()) {
+    return;
+  }
+
+  const size_t last = in.size() - 1;
+  for (size_t i = 0; i < last; ++i) {
+    Iterator end = buffer + offsets[i + 1] - Separator::size;
+    write_value<Unsigned>(buffer + offsets[i], end, in[i]);
+    Separator::write(end);
+  }
+
+  write_value<Unsigned>(buffer + offsets[last], buffer + offsets[last + 1], in[last]);
+}
+
+// Both passes, `result` resized to exactly total size + terminating '\0'
+// (allocated once if capacity is enough for the next batches).
+// Return total size
+template <class Separator = separator::None, class Vector>
+inline size_t generate(
+    const Vector& in, Offsets& offsets, std::vector<char>& result
+) {
+  const size_t total = count<Separator>(in, offsets);
+  result.resize(total + 1);
+  write<Separator>(result.data(), in, offsets);
+  result[total] = '\0';
+  return total;
+}
+
+} // namespace twopass
+
+#endif // ALGOS_TWOPASS_HPP_
@@ -0,0 +1,124 @@
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+// Compare two result sets (see Results.hpp), report kernels which are
+// slower/faster than baseline by more than `threshold` percent:
+//   > int_dec_compare <baseline> <current> [threshold]
+//   * baseline, current: JSON/CSV from INT_DEC_RESULTS or text output
+//     of int_dec_format_test (see results/ directory)
+//   * threshold: percent of ns/value, default 5
+// Difference is ignored if confidence intervals of medians overlap
+// (if both results have them). Exit code is EXIT_FAILURE if any
+// regression found.
+
+#include <cstdlib> // EXIT_SUCCESS
+#include <iomanip> // std::setw
+#include <iostream> // std::cout
+#include <map>
+#include <stdexcept> // std::runtime_error
+#include <string>
+
+#include "Results.hpp"
+#include "Statistics.hpp"
+
+// Confidence interval of median is known
+bool have_interval(const results::Record& record) {
+  return record.ci_high_ns > 0 &&
+      record.samples - record.outliers >= benchmark::Statistics::MIN_SAMPLES;
+}
+
+// Confidence intervals overlap: difference is not significant
+bool intervals_overlap(
+    const results::Record& baseline, const results::Record& current
+) {
+  if (!have_interval(baseline) || !have_interval(current)) {
+    return false;
+  }
+  const double scale =
+      static_cast<double>(baseline.values) / static_cast<double>(current.values);
+  return current.ci_low_ns * scale <= baseline.ci_high_ns &&
+      baseline.ci_low_ns <= current.ci_high_ns * scale;
+}
+
+void print(
+    const char* status, double change, const results::Record& baseline,
+    const results::Record& current
+) {
+  std::cout << std::setw(12) << status << " ";
+  std::cout << (change > 0 ? "+" : "") << change << "% ";
+  std::cout << results::key(current) << " [ns/value:";
+  std::cout << baseline.ns_per_value << " -> " << current.ns_per_value;
+  if (baseline.cycles >= 0 && current.cycles >= 0) {
+    std::cout << " cycles/value:";
+    std::cout << baseline.cycles << " -> " << current.cycles;
+  }
+  std::cout << "]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  try {
+    if (argc != 3 && argc != 4) {
+      std::cerr << "usage: " << argv[0];
+      std::cerr << " <baseline> <current> [threshold]" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const double threshold = (argc == 4) ? std::stod(argv[3]) : 5.0;
+    if (threshold < 0) {
+      throw std::runtime_error("Negative threshold");
+    }
+
+    std::map<std::string, results::Record> baseline;
+    for (auto& i: results::read(argv[1])) {
+      baseline[results::key(i)] = i;
+    }
+
+    const results::Records current = results::read(argv[2]);
+
+    int regressions = 0;
+    int improvements = 0;
+    int same = 0;
+    int added = 0;
+
+    for (auto& i: current) {
+      auto it = baseline.find(results::key(i));
+      if (it == baseline.end()) {
+        ++added;
+        continue;
+      }
+      const results::Record& base = it->second;
+
+      if (base.ns_per_value <= 0 || i.ns_per_value <= 0) {
+        ++same;
+        continue;
+      }
+
+      const double change = 100 * (i.ns_per_value / base.ns_per_value - 1);
+      const bool significant = !intervals_overlap(base, i);
+
+      if (change > threshold && significant) {
+        print("REGRESSION", change, base, i);
+        ++regressions;
+      }
+      else if (change < -threshold && significant) {
+        print("improvement", change, base, i);
+        ++improvements;
+      }
+      else {
+        ++same;
+      }
+    }
+
+    std::cout << "Compared with threshold " << threshold << "%: ";
+    std::cout << "regressions:" << regressions << " ";
+    std::cout << "improvements:" << improvements << " ";
+    std::cout << "same:" << same << " ";
+    std::cout << "not in baseline:" << added << std::endl;
+
+    return (regressions == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  catch (std::exception& exc) {
+    std::cerr << exc.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
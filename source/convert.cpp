@@ -0,0 +1,285 @@
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+// Convert file of raw little-endian integers to text (one value per line):
+//   > int_dec_convert <type> <algo> <input> <output>
+//   * type: int16, int32, int64, uint16, uint32, uint64,
+//     int128, uint128 (if supported by compiler)
+//   * algo: counting, reciprocal, alexandrescu, tmpbuf, reverse
+// Input and output files are memory-mapped, size of output is counted
+// before conversion (output file grown once by `ftruncate`).
+
+#include <cerrno> // errno
+#include <cstdint> // int16_t
+#include <cstdlib> // EXIT_SUCCESS
+#include <cstring> // std::strerror
+#include <iostream> // std::cout
+#include <stdexcept> // std::runtime_error
+#include <string>
+#include <type_traits> // std::make_unsigned
+
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // ftruncate
+
+#include "Int128.hpp"
+#include "Timer.hpp"
+#include "alexandrescu.hpp"
+#include "counting.hpp"
+#include "reciprocal.hpp"
+#include "reverse.hpp"
+#include "tmpbuf.hpp"
+#include "twopass.hpp"
+
+void throw_error(const std::string& message) {
+  throw std::runtime_error(message + ": " + std::strerror(errno));
+}
+
+class File {
+ public:
+  File(const char* path, int flags): fd_(::open(path, flags, 0644)) {
+    if (fd_ < 0) {
+      throw_error(std::string("Can't open ") + path);
+    }
+  }
+
+  ~File() {
+    ::close(fd_);
+  }
+
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  int fd() const {
+    return fd_;
+  }
+
+  size_t size() const {
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+      throw_error("fstat failed");
+    }
+    return static_cast<size_t>(info.st_size);
+  }
+
+  void resize(size_t size) {
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      throw_error("ftruncate failed");
+    }
+  }
+
+ private:
+  const int fd_;
+};
+
+class Mapping {
+ public:
+  Mapping(const File& file, size_t size, int protection):
+      size_(size),
+      data_(nullptr) {
+    if (size_ == 0) {
+      return;
+    }
+    void* result = ::mmap(nullptr, size_, protection, MAP_SHARED, file.fd(), 0);
+    if (result == MAP_FAILED) {
+      throw_error("mmap failed");
+    }
+    data_ = static_cast<char*>(result);
+
+    // Both input and output are accessed once from begin to end
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+
+  ~Mapping() {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+  }
+
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+
+  char* data() const {
+    return data_;
+  }
+
+ private:
+  const size_t size_;
+  char* data_;
+};
+
+template <class Integer>
+inline Integer load_little_endian(const char* data) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+  // compiled to one load on little-endian machine
+  Unsigned result = 0;
+  for (size_t i = 0; i < sizeof(Integer); ++i) {
+    result = static_cast<Unsigned>(result | (Unsigned(bytes[i]) << (8 * i)));
+  }
+  return static_cast<Integer>(result);
+}
+
+// Exact size of output (values and '\n')
+template <class Integer>
+size_t count_size(const char* input, size_t values) {
+  size_t total = 0;
+  for (size_t i = 0; i < values; ++i) {
+    const Integer value = load_little_endian<Integer>(input + i * sizeof(Integer));
+    total += twopass::length(value) + 1;
+  }
+  return total;
+}
+
+template <class Integer, void (*generate)(char*&, Integer)>
+char* format_all(const char* input, size_t values, char* sink) {
+  for (size_t i = 0; i < values; ++i) {
+    generate(sink, load_little_endian<Integer>(input + i * sizeof(Integer)));
+    *sink = '\n';
+    ++sink;
+  }
+  return sink;
+}
+
+bool is_known_algo(const std::string& algo) {
+  return
+      algo == "counting" ||
+      algo == "reciprocal" ||
+      algo == "alexandrescu" ||
+      algo == "tmpbuf" ||
+      algo == "reverse";
+}
+
+template <class Integer>
+char* format_all(
+    const std::string& algo, const char* input, size_t values, char* sink
+) {
+  if (algo == "counting") {
+    return format_all<Integer, counting::generate<Integer>>(input, values, sink);
+  }
+  if (algo == "reciprocal") {
+    return format_all<Integer, reciprocal::generate<Integer>>(input, values, sink);
+  }
+  if (algo == "alexandrescu") {
+    return format_all<Integer, alexandrescu::generate<Integer>>(input, values, sink);
+  }
+  if (algo == "tmpbuf") {
+    return format_all<Integer, tmpbuf::generate<Integer>>(input, values, sink);
+  }
+  if (algo == "reverse") {
+    return format_all<Integer, reverse::generate<Integer>>(input, values, sink);
+  }
+  throw std::runtime_error("Unknown algorithm: " + algo);
+}
+
+template <class Integer>
+void convert(const std::string& algo, const char* input_path, const char* output_path) {
+  using Seconds = std::chrono::duration<double>;
+
+  File input_file(input_path, O_RDONLY);
+  const size_t input_size = input_file.size();
+  if (input_size % sizeof(Integer) != 0) {
+    throw std::runtime_error("Input size is not a multiple of value size");
+  }
+  const size_t values = input_size / sizeof(Integer);
+
+  Mapping input(input_file, input_size, PROT_READ);
+
+  const Timer::TimePoint start = Timer::now();
+  const size_t output_size = count_size<Integer>(input.data(), values);
+  const Timer::TimePoint counted = Timer::now();
+
+  File output_file(output_path, O_RDWR | O_CREAT | O_TRUNC);
+  output_file.resize(output_size);
+  Mapping output(output_file, output_size, PROT_READ | PROT_WRITE);
+
+  const Timer::TimePoint mapped = Timer::now();
+  char* end = format_all<Integer>(algo, input.data(), values, output.data());
+  const Timer::TimePoint stop = Timer::now();
+
+  if (static_cast<size_t>(end - output.data()) != output_size) {
+    throw std::runtime_error("Output size mismatch");
+  }
+
+  const double count_seconds =
+      std::chrono::duration_cast<Seconds>(counted - start).count();
+  const double format_seconds =
+      std::chrono::duration_cast<Seconds>(stop - mapped).count();
+  const double total_seconds =
+      std::chrono::duration_cast<Seconds>(stop - start).count();
+  const double megabytes = static_cast<double>(output_size) / 1e6;
+
+  std::cout << "Converted " << values << " values (" << input_size;
+  std::cout << " bytes) to " << output_size << " bytes with " << algo;
+  std::cout << std::endl;
+  std::cout << "count s:" << count_seconds << " ";
+  std::cout << "format s:" << format_seconds << " ";
+  std::cout << "total s:" << total_seconds << " ";
+  std::cout << "values/s:" << values / total_seconds << " ";
+  std::cout << "MB/s:" << megabytes / total_seconds << std::endl;
+}
+
+int main(int argc, char** argv) {
+  try {
+    if (argc != 5) {
+      std::cerr << "Usage: " << argv[0];
+      std::cerr << " <type> <algo> <input> <output>" << std::endl;
+      std::cerr << "type: int16, int32, int64, uint16, uint32, uint64";
+#if HAVE_INT128
+      std::cerr << ", int128, uint128";
+#endif
+      std::cerr << std::endl;
+      std::cerr << "algo: counting, reciprocal, alexandrescu, tmpbuf, reverse";
+      std::cerr << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const std::string type(argv[1]);
+    const std::string algo(argv[2]);
+
+    if (!is_known_algo(algo)) {
+      throw std::runtime_error("Unknown algorithm: " + algo);
+    }
+
+    if (type == "int16") {
+      convert<int16_t>(algo, argv[3], argv[4]);
+    }
+    else if (type == "int32") {
+      convert<int32_t>(algo, argv[3], argv[4]);
+    }
+    else if (type == "int64") {
+      convert<int64_t>(algo, argv[3], argv[4]);
+    }
+    else if (type == "uint16") {
+      convert<uint16_t>(algo, argv[3], argv[4]);
+    }
+    else if (type == "uint32") {
+      convert<uint32_t>(algo, argv[3], argv[4]);
+    }
+    else if (type == "uint64") {
+      convert<uint64_t>(algo, argv[3], argv[4]);
+    }
+#if HAVE_INT128
+    else if (type == "int128") {
+      convert<int128_t>(algo, argv[3], argv[4]);
+    }
+    else if (type == "uint128") {
+      convert<uint128_t>(algo, argv[3], argv[4]);
+    }
+#endif
+    else {
+      throw std::runtime_error("Unknown type: " + type);
+    }
+    return EXIT_SUCCESS;
+  }
+  catch (std::exception& exc) {
+    std::cerr << exc.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    std::cerr << "Unknown exception" << std::endl;
+    return EXIT_FAILURE;
+  }
+}
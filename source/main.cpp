@@ -1,12 +1,31 @@
 // Copyright (c) 2014, Ruslan Baratov
 // All rights reserved.
 
+#include <algorithm> // std::replace, std::fill
 #include <cstdlib> // EXIT_SUCCESS
+#include <cstring> // std::strlen
 #include <iostream> // std::cerr
+#include <memory> // std::unique_ptr
+#include <string>
+#include <type_traits> // std::integral_constant
+#include <vector>
+
+#if !defined(_WIN32)
+# include <fcntl.h> // open
+# include <unistd.h> // pipe
+#endif
 
 #include "Runner.hpp"
-#include "Algos.hpp"
+#include "ColumnRunner.hpp"
+#include "CountRunner.hpp"
+#include "Coalescer.hpp"
+#include "Distribution.hpp"
+#include "FdSink.hpp"
+#include "Options.hpp"
 #include "Output.ipp"
+#include "ParseRunner.hpp"
+#include "Pipeline.hpp"
+#include "Registry.hpp"
 
 template <class Type> const char* get_name();
 
@@ -30,38 +49,385 @@ const char* get_name<long long>() {
   return "long long";
 }
 
-template <class Type> void run_with_type(
-    size_t output_size, int digit, bool have_sign, bool same_size
-) {
-  using In = Input<Type>;
+template <>
+const char* get_name<unsigned short>() {
+  return "unsigned short";
+}
 
-#if !defined(NDEBUG)
-  std::cout << "*** DEBUG BUILD ***" << std::endl;
-  // Print config before assertions
-  std::cout << get_name<Type>() << " digit:" << digit << " ";
-  std::cout << "sign:" << have_sign << std::endl;
+template <>
+const char* get_name<unsigned int>() {
+  return "unsigned int";
+}
+
+template <>
+const char* get_name<unsigned long>() {
+  return "unsigned long";
+}
+
+template <>
+const char* get_name<unsigned long long>() {
+  return "unsigned long long";
+}
+
+#if HAVE_INT128
+template <>
+const char* get_name<int128_t>() {
+  return "__int128";
+}
+
+template <>
+const char* get_name<uint128_t>() {
+  return "unsigned __int128";
+}
 #endif
 
+// Name for command line: as `get_name` or with '_' instead of spaces
+// (e.g. `long_long`)
+inline std::string option_name(const char* name) {
+  std::string result(name);
+  std::replace(result.begin(), result.end(), ' ', '_');
+  return result;
+}
+
+template <class Type>
+bool is_type_selected(const Options& options) {
+  return options.selected("type", get_name<Type>()) ||
+      options.selected("type", option_name(get_name<Type>()));
+}
+
+// Names of registry items (see Registry.hpp)
+class TypeNames {
+ public:
+  template <class Type>
+  void operator()(const Type&) {
+    names.push_back(get_name<Type>());
+  }
+
+  std::vector<std::string> names;
+};
+
+class AlgoNames {
+ public:
+  template <class Algo>
+  void operator()(const Algo&) {
+    names.push_back(Algo::name());
+  }
+
+  std::vector<std::string> names;
+};
+
+template <class List>
+std::vector<std::string> algo_names() {
+  AlgoNames result;
+  registry::for_each(List(), result);
+  return result.names;
+}
+
+// Any algorithm of `names` selected by --algo
+inline bool is_any_selected(
+    const Options& options, const std::vector<std::string>& names
+) {
+  for (auto& i: names) {
+    if (options.selected("algo", i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline std::vector<benchmark::Task*> pointers(
+    const std::vector<std::unique_ptr<benchmark::Task>>& tasks
+) {
+  std::vector<benchmark::Task*> result;
+  for (auto& i: tasks) {
+    result.push_back(i.get());
+  }
+  return result;
+}
+
+// Runners of formatters selected by --algo (see Registry.hpp)
+template <class In>
+class FormatTasks {
+ public:
+  FormatTasks(
+      const Options& options,
+      const In& input,
+      Output& output,
+      size_t output_size
+  ):
+      options_(options),
+      input_(input),
+      output_(output),
+      output_size_(output_size) {
+  }
+
+  template <class Formatter>
+  void operator()(const Formatter&) {
+    using Algo = typename Formatter::algo_t;
+    using Format = typename Formatter::format_t;
+    if (!options_.selected("algo", Algo::name())) {
+      return;
+    }
+    tasks_.emplace_back(
+        new Runner<In, Algo, Format>(input_, output(Format()), Algo::name())
+    );
+  }
+
+  std::vector<benchmark::Task*> tasks() const {
+    return pointers(tasks_);
+  }
+
+ private:
+  Output& output(format::Plain) {
+    return output_;
+  }
+
+  // Fixed-point output: own expected text, decimal point and leading zeros
+  // of fraction don't fit into `In::bytes_per_value`
+  template <int scale>
+  Output& output(format::Fixed<scale> format) {
+    const size_t digits = std::numeric_limits<typename In::value_t>::digits10;
+    const size_t fraction = static_cast<size_t>(scale);
+    const size_t zeros = (fraction > digits) ? (fraction - digits) : 0;
+    const size_t size = output_size_ + input_.size() * (1 + zeros);
+    outputs_.emplace_back(new Output(size, input_, format));
+    return *outputs_.back();
+  }
+
+  // Hex/octal output: own expected text, 22 octal digits of 64-bit value
+  // don't fit into `In::bytes_per_value`
+  template <int base, bool upper>
+  Output& output(format::Radix<base, upper> format) {
+    using Format = format::Radix<base, upper>;
+    const size_t width = Format::template width<typename In::value_t>();
+    const size_t size = output_size_ + input_.size() * width;
+    outputs_.emplace_back(new Output(size, input_, format));
+    return *outputs_.back();
+  }
+
+  // Fixed width output: own expected text
+  template <class Format>
+  Output& output(Format format) {
+    outputs_.emplace_back(new Output(output_size_, input_, format));
+    return *outputs_.back();
+  }
+
+  const Options& options_;
+  const In& input_;
+  Output& output_;
+  const size_t output_size_;
+  std::vector<std::unique_ptr<Output>> outputs_;
+  std::vector<std::unique_ptr<benchmark::Task>> tasks_;
+};
+
+// Runners of parsers selected by --algo (see Registry.hpp)
+template <class In>
+class ParseTasks {
+ public:
+  ParseTasks(
+      const Options& options, const In& input, const char* begin, const char* end
+  ):
+      options_(options),
+      input_(input),
+      begin_(begin),
+      end_(end) {
+  }
+
+  template <class Parser>
+  void operator()(const Parser&) {
+    if (!options_.selected("algo", Parser::name())) {
+      return;
+    }
+    tasks_.emplace_back(
+        new ParseRunner<In, Parser>(input_, begin_, end_, Parser::name())
+    );
+  }
+
+  std::vector<benchmark::Task*> tasks() const {
+    return pointers(tasks_);
+  }
+
+ private:
+  const Options& options_;
+  const In& input_;
+  const char* begin_;
+  const char* end_;
+  std::vector<std::unique_ptr<benchmark::Task>> tasks_;
+};
+
+// Operations on input values alone (no text buffer): items of `list_t`
+// selected by --algo, runner `task_t<In, Item>`
+class CountOperation {
+ public:
+  using list_t = registry::Counters;
+
+  template <class In, class Counter>
+  using task_t = CountRunner<In, Counter>;
+
+  static const char* name() {
+    return "count";
+  }
+
+  static const char* title() {
+    return "Counting digits of";
+  }
+};
+
+class ColumnOperation {
+ public:
+  using list_t = registry::Columns;
+
+  template <class In, class Builder>
+  using task_t = ColumnRunner<In, Builder>;
+
+  static const char* name() {
+    return "column";
+  }
+
+  static const char* title() {
+    return "Building string column of";
+  }
+};
+
+// Runners of `Operation` items selected by --algo (see Registry.hpp)
+template <class In, class Operation>
+class InputTasks {
+ public:
+  InputTasks(const Options& options, const In& input):
+      options_(options),
+      input_(input) {
+  }
+
+  template <class Item>
+  void operator()(const Item& item) {
+    using Type = typename In::value_t;
+    using Supported = std::integral_constant<
+        bool, IsSupported<Item, Type>::value
+    >;
+    if (!options_.selected("algo", Item::name())) {
+      return;
+    }
+    add(item, Supported());
+  }
+
+  std::vector<benchmark::Task*> tasks() const {
+    return pointers(tasks_);
+  }
+
+ private:
+  template <class Item>
+  void add(const Item&, std::true_type) {
+    using Task = typename Operation::template task_t<In, Item>;
+    tasks_.emplace_back(new Task(input_, Item::name()));
+  }
+
+  // not instantiated for unsupported types
+  template <class Item>
+  void add(const Item&, std::false_type) {
+  }
+
+  const Options& options_;
+  const In& input_;
+  std::vector<std::unique_ptr<benchmark::Task>> tasks_;
+};
+
+// Input parameters not applicable for type
+template <class In>
+bool is_skipped(
+    size_t output_size,
+    int digit,
+    bool have_sign,
+    bool same_size,
+    const Distribution& distribution
+) {
+  using Type = typename In::value_t;
+
   if (digit != 0) {
     if (std::pow(10, digit) > std::numeric_limits<Type>::max()) {
       std::cout << "Skip: too much digits(" << digit << ") ";
       std::cout << "for current type(" << get_name<Type>() << ")" << std::endl;
-      return;
+      return true;
     }
   }
 
+  if (output_size < In::bytes_per_value) {
+    std::cout << "Skip: buffer(" << output_size << ") too small ";
+    std::cout << "for current type(" << get_name<Type>() << ")" << std::endl;
+    return true;
+  }
+
+  if (have_sign && !std::numeric_limits<Type>::is_signed) {
+    std::cout << "Skip: negative values for unsigned type(";
+    std::cout << get_name<Type>() << ")" << std::endl;
+    return true;
+  }
+
   if (same_size) {
     if (have_sign) {
       std::cout << "Skip: negative/positive with same size" << std::endl;
-      return;
+      return true;
     }
     if (digit == 0) {
         std::cout << "Skip: same size with any number of digits" << std::endl;
-      return;
+      return true;
     }
   }
 
-  In input(output_size, digit, have_sign, same_size);
+  if (!distribution.fits<Type>(have_sign)) {
+    std::cout << "Skip: no values of " << distribution.name() << " ";
+    std::cout << "in range of type(" << get_name<Type>() << ")" << std::endl;
+    return true;
+  }
+
+  return false;
+}
+
+// Input configuration for results file (see Results.hpp)
+template <class In>
+results::Config make_config(
+    const char* operation,
+    const In& input,
+    size_t buffer,
+    int digit,
+    bool have_sign,
+    bool same_size,
+    const Distribution& distribution
+) {
+  results::Config config;
+  config.operation = operation;
+  config.type = get_name<typename In::value_t>();
+  config.separator = In::separator_t::name();
+  config.digit = digit;
+  config.sign = have_sign;
+  config.same_size = same_size;
+  config.distribution = distribution.name();
+  config.buffer = buffer;
+  config.values = input.size();
+  return config;
+}
+
+template <class Type, class Separator> void run_with_type(
+    const Options& options,
+    size_t output_size,
+    int digit,
+    bool have_sign,
+    bool same_size,
+    const Distribution& distribution
+) {
+  using In = Input<Type, Separator>;
+
+#if !defined(NDEBUG)
+  std::cout << "*** DEBUG BUILD ***" << std::endl;
+  // Print config before assertions
+  std::cout << get_name<Type>() << " digit:" << digit << " ";
+  std::cout << "sign:" << have_sign << std::endl;
+#endif
+
+  if (is_skipped<In>(output_size, digit, have_sign, same_size, distribution)) {
+    return;
+  }
+
+  In input(output_size, digit, have_sign, same_size, distribution);
   Output output(output_size, input);
 
   std::cout << "Converting " << input.values().size() << " ";
@@ -79,6 +445,12 @@ template <class Type> void run_with_type(
   if (same_size) {
     std::cout << "(same size) ";
   }
+  if (distribution.kind() != Distribution::UNIFORM) {
+    std::cout << "(distribution " << distribution.name() << ") ";
+  }
+  if (Separator::size != 0) {
+    std::cout << "separated by " << Separator::name() << " ";
+  }
   std::cout << "to buffer " << output.size() << " bytes" << std::endl;
 
   std::cout << "sizeof(short, int, long, long long, void*): ";
@@ -88,102 +460,937 @@ template <class Type> void run_with_type(
   std::cout << sizeof(long long) << " ";
   std::cout << sizeof(void*) << std::endl;
 
-  Runner<In, AlgoFmtFormat> algo_fmt_format(input, output, "fmt::FormatInt");
-  Runner<In, AlgoBoostKarma> algo_boost_karma(input, output, "boost::spirit::karma");
-  Runner<In, AlgoAlexandrescu> algo_alexandrescu(input, output, "alexandrescu");
-  Runner<In, AlgoReverse> algo_reverse(input, output, "reverse");
-  Runner<In, AlgoTmpbuf> algo_tmpbuf(input, output, "tmpbuf");
-  Runner<In, AlgoCounting> algo_counting(input, output, "counting");
+  FormatTasks<In> format_tasks(options, input, output, output_size);
+  registry::for_each(registry::Formatters(), format_tasks);
+
+  if (options.selected("algo", AlgoDispatch::name())) {
+    const auto& dispatcher = dispatch::instance<Type, Separator>();
+    std::cout << "Dispatch: " << dispatcher.name() << " (";
+    if (dispatcher.from_cache()) {
+      std::cout << "from cache";
+    }
+    else {
+      using Ms = std::chrono::milliseconds;
+      std::cout << "calibration ms:";
+      std::cout << std::chrono::duration_cast<Ms>(dispatcher.calibration()).count();
+    }
+    std::cout << ", cpu: " << dispatch::cpu_features() << ")" << std::endl;
+  }
+
+  const std::vector<benchmark::Task*> tasks = format_tasks.tasks();
+
+  benchmark::run_interleaved(tasks);
+  benchmark::output_results(
+      tasks,
+      make_config(
+          "format",
+          input,
+          output.size(),
+          digit,
+          have_sign,
+          same_size,
+          distribution
+      )
+  );
+}
+
+// Parsing of text produced by `counting` (values separated by `Separator`)
+template <class Type, class Separator> void run_parse_with_type(
+    const Options& options,
+    size_t output_size,
+    int digit,
+    bool have_sign,
+    bool same_size,
+    const Distribution& distribution
+) {
+  using In = Input<Type, Separator>;
+
+  if (is_skipped<In>(output_size, digit, have_sign, same_size, distribution)) {
+    return;
+  }
+
+  In input(output_size, digit, have_sign, same_size, distribution);
+  Output output(output_size, input);
+
+  AlgoCounting::run<Separator>(output.buffer(), input.values());
+  output.use_buffer("counting");
+
+  const char* begin = output.buffer();
+  const char* end = begin + std::strlen(begin);
+
+  std::cout << "Parsing " << input.values().size() << " ";
+  std::cout << get_name<Type>() << " with ";
+  if (digit == 0) {
+    std::cout << "ANY ";
+  }
+  else {
+    std::cout << digit << " ";
+  }
+  std::cout << "base-10 digits ";
+  if (!have_sign) {
+    std::cout << "(no sign) ";
+  }
+  if (same_size) {
+    std::cout << "(same size) ";
+  }
+  if (distribution.kind() != Distribution::UNIFORM) {
+    std::cout << "(distribution " << distribution.name() << ") ";
+  }
+  std::cout << "separated by " << Separator::name() << " ";
+  std::cout << "from buffer " << (end - begin) << " bytes" << std::endl;
+
+  ParseTasks<In> parse_tasks(options, input, begin, end);
+  registry::for_each(registry::Parsers(), parse_tasks);
+
+  const std::vector<benchmark::Task*> tasks = parse_tasks.tasks();
+
+  benchmark::run_interleaved(tasks);
+  benchmark::output_results(
+      tasks,
+      make_config(
+          "parse",
+          input,
+          output.size(),
+          digit,
+          have_sign,
+          same_size,
+          distribution
+      )
+  );
+}
+
+// Operation on the same input as formatters (see CountOperation)
+template <class Type, class Operation> void run_input_with_type(
+    const Options& options,
+    size_t output_size,
+    int digit,
+    bool have_sign,
+    bool same_size,
+    const Distribution& distribution
+) {
+  using In = Input<Type>;
+
+  if (is_skipped<In>(output_size, digit, have_sign, same_size, distribution)) {
+    return;
+  }
+
+  In input(output_size, digit, have_sign, same_size, distribution);
+
+  std::cout << Operation::title() << " " << input.values().size() << " ";
+  std::cout << get_name<Type>() << " with ";
+  if (digit == 0) {
+    std::cout << "ANY ";
+  }
+  else {
+    std::cout << digit << " ";
+  }
+  std::cout << "base-10 digits";
+  if (!have_sign) {
+    std::cout << " (no sign)";
+  }
+  if (same_size) {
+    std::cout << " (same size)";
+  }
+  if (distribution.kind() != Distribution::UNIFORM) {
+    std::cout << " (distribution " << distribution.name() << ")";
+  }
+  std::cout << std::endl;
+
+  InputTasks<In, Operation> input_tasks(options, input);
+  registry::for_each(typename Operation::list_t(), input_tasks);
+
+  const std::vector<benchmark::Task*> tasks = input_tasks.tasks();
+  if (tasks.empty()) {
+    std::cout << "Skip: no selected algorithm for current type(";
+    std::cout << get_name<Type>() << ")" << std::endl;
+    return;
+  }
+
+  benchmark::run_interleaved(tasks);
+  benchmark::output_results(
+      tasks,
+      make_config(
+          Operation::name(),
+          input,
+          output_size,
+          digit,
+          have_sign,
+          same_size,
+          distribution
+      )
+  );
+}
+
+// Throughput of `parallel` algorithm for 1..N threads
+void run_parallel_scaling() {
+  using Type = long long;
+  using In = Input<Type>;
+
+#if defined(NDEBUG)
+  const size_t output_size = 8 * 1024 * 1024;
+  const int iterations = std::max(
+      1, TOTAL_ITERATIONS / static_cast<int>(output_size / In::bytes_per_value)
+  );
+#else
+  const size_t output_size = 256 * 1024;
+  const int iterations = 1;
+#endif
+
+  In input(output_size, 0, true, false);
+  Output output(output_size, input);
+
+  std::cout << "Parallel: converting " << input.values().size() << " ";
+  std::cout << get_name<Type>() << " with ANY base-10 digits ";
+  std::cout << "to buffer " << output.size() << " bytes" << std::endl;
+
+  // worker threads inherit affinity of the main thread
+  const benchmark::Unpinned unpinned;
+
+  const unsigned max_threads = parallel::default_threads();
+  std::vector<unsigned> threads_variants;
+  for (unsigned threads = 1; threads < max_threads; threads *= 2) {
+    threads_variants.push_back(threads);
+  }
+  threads_variants.push_back(max_threads);
+
+  using Seconds = std::chrono::duration<double>;
+  double single_thread_seconds = 0;
 
-  std::cout << "Run tests";
+  for (auto threads: threads_variants) {
+#if !defined(NDEBUG)
+    output.clear();
+#endif
+    // untimed: creates worker threads (see parallel::Workers)
+    size_t bytes = parallel::generate(output.buffer(), input.values(), threads);
+
+    const Timer::TimePoint start = Timer::now();
+    for (int i = 0; i < iterations; ++i) {
+      char* buffer = output.buffer();
+      bytes = parallel::generate(buffer, input.values(), threads);
+      buffer[bytes] = '\0';
+
+      // prevent compiler optimization
+      output.use_buffer("parallel");
+    }
+    const Timer::TimePoint stop = Timer::now();
 
-  enum {
-    N = 5
+    const double seconds =
+        std::chrono::duration_cast<Seconds>(stop - start).count();
+    if (threads == 1) {
+      single_thread_seconds = seconds;
+    }
+
+    const double values = static_cast<double>(input.size()) * iterations;
+    const double megabytes = static_cast<double>(bytes) * iterations / 1e6;
+
+    std::cout << std::setw(40) << "threads:" + std::to_string(threads);
+    std::cout << " [";
+    std::cout << "s:" << seconds << " ";
+    std::cout << "values/s:" << values / seconds << " ";
+    std::cout << "MB/s:" << megabytes / seconds << " ";
+    std::cout << "speedup:" << single_thread_seconds / seconds;
+    std::cout << "]" << std::endl;
+  }
+}
+
+// Jobs/s and latency of every job (from submit to finish), no outliers
+// rejected: tail latency is the point
+template <class Job>
+void print_jobs_result(
+    const std::string& name,
+    const std::vector<Job>& jobs,
+    Timer::TimePoint start,
+    Timer::TimePoint stop
+) {
+  using Seconds = std::chrono::duration<double>;
+  const double seconds =
+      std::chrono::duration_cast<Seconds>(stop - start).count();
+
+  benchmark::Durations latencies;
+  for (auto& i: jobs) {
+    latencies.push_back(
+        std::chrono::duration_cast<benchmark::Duration>(i.finished - i.submitted)
+    );
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  // nearest rank
+  auto percentile = [&latencies](double percent) {
+    const size_t rank = static_cast<size_t>(
+        std::ceil(percent / 100 * static_cast<double>(latencies.size()))
+    );
+    return latencies[std::max(rank, size_t(1)) - 1].count();
   };
 
-  for (int i = 0; i < N; ++i) {
-    std::cout << " #" << i << std::flush;
-
-    algo_fmt_format.run();
-    algo_boost_karma.run();
-    algo_alexandrescu.run();
-    algo_reverse.run();
-    algo_tmpbuf.run();
-    algo_counting.run();
-  }
-
-  std::cout << "Results: " << std::endl;
-  Timer::Duration algo_fmt_format_avg = algo_fmt_format.average();
-  Timer::Duration algo_boost_karma_avg = algo_boost_karma.average();
-  Timer::Duration algo_alexandrescu_avg = algo_alexandrescu.average();
-  Timer::Duration algo_reverse_avg = algo_reverse.average();
-  Timer::Duration algo_tmpbuf_avg = algo_tmpbuf.average();
-  Timer::Duration algo_counting_avg = algo_counting.average();
-
-  Timer::Duration min = std::min(
-      {
-      algo_fmt_format_avg,
-      algo_boost_karma_avg,
-      algo_alexandrescu_avg,
-      algo_reverse_avg,
-      algo_tmpbuf_avg,
-      algo_counting_avg
+  std::cout << std::setw(40) << name;
+  std::cout << " [";
+  std::cout << "s:" << seconds << " ";
+  std::cout << "jobs/s:" << static_cast<double>(jobs.size()) / seconds << " ";
+  std::cout << "p50_ns:" << percentile(50) << " ";
+  std::cout << "p99_ns:" << percentile(99);
+  std::cout << "]" << std::endl;
+
+#if !defined(NDEBUG)
+  for (auto& i: jobs) {
+    std::ostringstream expected;
+    bool first = true;
+    for (auto value: i.values) {
+      if (!first) {
+        expected << separator::Comma::str();
+      }
+      first = false;
+      expected << value;
+    }
+    if (std::string(i.sink) != expected.str()) {
+      throw std::runtime_error("Coalescing check failed: " + name);
+    }
+  }
+#endif
+}
+
+// Many tiny jobs (values of 30/300 bytes rows): `AlgoCounting::run` called
+// by caller vs jobs coalesced into batches for worker pool (see
+// Coalescer.hpp), same batch sizes and timestamps for both
+void run_coalescing() {
+  using Type = long long;
+  using In = Input<Type, separator::Comma>;
+  using Job = coalesce::Job<Type>;
+
+#if defined(NDEBUG)
+  const size_t jobs_number = 200000;
+#else
+  const size_t jobs_number = 2000;
+#endif
+
+  In input(1024 * 1024, 0, true, false);
+  const unsigned threads = parallel::default_threads();
+
+  for (size_t output_size: {30, 300}) {
+    const size_t job_values = output_size / In::bytes_per_value;
+    const size_t job_bytes = job_values * In::bytes_per_value;
+
+    std::cout << "Coalescing: " << jobs_number << " jobs of " << job_values;
+    std::cout << " " << get_name<Type>() << " separated by ";
+    std::cout << In::separator_t::name() << ", worker threads: " << threads;
+    std::cout << std::endl;
+
+    std::vector<char> buffer(jobs_number * job_bytes);
+    std::vector<Job> jobs(jobs_number);
+    size_t next_value = 0;
+    for (size_t i = 0; i < jobs_number; ++i) {
+      for (size_t j = 0; j < job_values; ++j) {
+        jobs[i].values.push_back(input.values()[next_value]);
+        next_value = (next_value + 1) % input.size();
+      }
+      jobs[i].sink = buffer.data() + i * job_bytes;
+    }
+
+    // every run checked on its own output: poisoned sinks, terminated by
+    // the last byte (overwritten by text of the longest job)
+    auto reset_sinks = [&]() {
+      std::fill(buffer.begin(), buffer.end(), '#');
+      for (size_t i = 0; i < jobs_number; ++i) {
+        jobs[i].sink[job_bytes - 1] = '\0';
+      }
+    };
+
+    const std::vector<size_t> batch_sizes = {1, 16, 256};
+
+    // caller converts every job, timestamps as in pool: one per submitted
+    // job, one per finished batch
+    for (size_t batch_size: batch_sizes) {
+      reset_sinks();
+      const Timer::TimePoint start = Timer::now();
+      for (size_t begin = 0; begin < jobs.size(); begin += batch_size) {
+        const size_t end = std::min(begin + batch_size, jobs.size());
+        for (size_t i = begin; i < end; ++i) {
+          jobs[i].submitted = Timer::now();
+        }
+        for (size_t i = begin; i < end; ++i) {
+          AlgoCounting::run<In::separator_t>(jobs[i].sink, jobs[i].values);
+        }
+        const Timer::TimePoint now = Timer::now();
+        for (size_t i = begin; i < end; ++i) {
+          jobs[i].finished = now;
+        }
+      }
+      const Timer::TimePoint stop = Timer::now();
+      print_jobs_result(
+          "direct batch:" + std::to_string(batch_size), jobs, start, stop
+      );
+    }
+
+    // worker threads inherit affinity of the main thread
+    const benchmark::Unpinned unpinned;
+
+    for (size_t batch_size: batch_sizes) {
+      coalesce::Pool<Type, In::separator_t> pool(threads, batch_size);
+
+      reset_sinks();
+      const Timer::TimePoint start = Timer::now();
+      for (auto& i: jobs) {
+        pool.submit(i);
       }
+      pool.wait();
+      const Timer::TimePoint stop = Timer::now();
+      print_jobs_result(
+          "pool batch:" + std::to_string(batch_size) +
+              " steals:" + std::to_string(pool.steals()),
+          jobs,
+          start,
+          stop
+      );
+    }
+  }
+}
+
+#if !defined(_WIN32)
+// End-to-end throughput: values formatted by `counting` into fixed size
+// buffer of FdSink, buffer written to file descriptor (syscalls included)
+void run_stream_to_fd(
+    const char* target_name, int fd, const Input<long long, separator::Newline>& input
+) {
+  using Separator = separator::Newline;
+
+#if defined(NDEBUG)
+  const int iterations = std::max(
+      1, TOTAL_ITERATIONS / static_cast<int>(input.size())
   );
+#else
+  const int iterations = 1;
+#endif
+
+  FdSink sink(fd);
+
+  const Timer::TimePoint start = Timer::now();
+  for (int i = 0; i < iterations; ++i) {
+    sink.write<Separator>(input.values(), counting::generate<long long>);
+    Separator::write(sink.reserve(Separator::size));
+  }
+  sink.flush();
+  const Timer::TimePoint stop = Timer::now();
+
+  using Seconds = std::chrono::duration<double>;
+  const double seconds =
+      std::chrono::duration_cast<Seconds>(stop - start).count();
+  const double values = static_cast<double>(input.size()) * iterations;
+  const double megabytes = static_cast<double>(sink.bytes_written()) / 1e6;
+
+  std::cout << std::setw(40) << target_name;
+  std::cout << " [";
+  std::cout << "s:" << seconds << " ";
+  std::cout << "values/s:" << values / seconds << " ";
+  std::cout << "MB/s:" << megabytes / seconds << " ";
+  std::cout << "buffer:" << sink.capacity();
+  std::cout << "]" << std::endl;
+}
+
+void run_stream() {
+  using Type = long long;
+  using In = Input<Type, separator::Newline>;
+
+#if defined(NDEBUG)
+  const size_t output_size = 8 * 1024 * 1024;
+#else
+  const size_t output_size = 256 * 1024;
+#endif
+
+  In input(output_size, 0, true, false);
+
+  std::cout << "Stream: converting " << input.values().size() << " ";
+  std::cout << get_name<Type>() << " with ANY base-10 digits ";
+  std::cout << "separated by " << In::separator_t::name() << " ";
+  std::cout << "to file descriptor" << std::endl;
+
+  const int null_fd = ::open("/dev/null", O_WRONLY);
+  if (null_fd < 0) {
+    throw std::runtime_error("Can't open /dev/null");
+  }
+  run_stream_to_fd("/dev/null", null_fd, input);
+  ::close(null_fd);
+
+  // pipe as a stand-in for socket, data consumed by reader thread
+  int pipe_fd[2];
+  if (::pipe(pipe_fd) != 0) {
+    throw std::runtime_error("Can't create pipe");
+  }
+
+  // reader thread on another CPU
+  const benchmark::Unpinned unpinned;
+
+  std::string received;
+  std::thread reader([&]() {
+    std::vector<char> buffer(FdSink::DEFAULT_CAPACITY);
+    while (true) {
+      const ssize_t result = ::read(pipe_fd[0], buffer.data(), buffer.size());
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result <= 0) {
+        break;
+      }
+#if !defined(NDEBUG)
+      received.append(buffer.data(), static_cast<size_t>(result));
+#endif
+    }
+  });
+
+  try {
+    run_stream_to_fd("pipe", pipe_fd[1], input);
+  }
+  catch (...) {
+    ::close(pipe_fd[1]);
+    reader.join();
+    ::close(pipe_fd[0]);
+    throw;
+  }
+
+  ::close(pipe_fd[1]);
+  reader.join();
+  ::close(pipe_fd[0]);
+
+#if !defined(NDEBUG)
+  std::ostringstream expected;
+  for (auto i: input.values()) {
+    expected << i << In::separator_t::str();
+  }
+  if (received != expected.str()) {
+    throw std::runtime_error("Stream check failed");
+  }
+#endif
+}
+
+// Pipeline of generate/format/write threads for every selected formatter
+// with plain output (see Pipeline.hpp)
+class PipelineTasks {
+ public:
+  using Type = long long;
+  using In = Input<Type, separator::Newline>;
+
+  PipelineTasks(const Options& options, const In& input, int fd):
+      options_(options),
+      input_(input),
+      fd_(fd) {
+  }
+
+  template <class Formatter>
+  void operator()(const Formatter&) {
+    using Algo = typename Formatter::algo_t;
+    using Plain = std::is_same<typename Formatter::format_t, format::Plain>;
+    using Supported = std::integral_constant<
+        bool, Runner<In, Algo>::enabled && Plain::value
+    >;
+    if (!options_.selected("algo", Algo::name())) {
+      return;
+    }
+    run(Algo(), Supported());
+  }
+
+ private:
+  template <class Algo>
+  void run(const Algo&, std::true_type) {
+#if defined(NDEBUG)
+    const uint64_t count = 32 * 1024 * 1024;
+#else
+    const uint64_t count = 100000;
+#endif
+    const size_t chunk_values = 4096;
+    const size_t ring_capacity = 8;
 
-  // Output results
-  algo_fmt_format.output_result(min);
-  algo_boost_karma.output_result(min);
-  algo_alexandrescu.output_result(min);
-  algo_reverse.output_result(min);
-  algo_tmpbuf.output_result(min);
-  algo_counting.output_result(min);
+    std::string copy;
+#if defined(NDEBUG)
+    std::string* check = nullptr;
+#else
+    std::string* check = &copy;
+#endif
+
+    const pipeline::Result result = pipeline::run<Algo, In::separator_t>(
+        input_.values(), count, fd_, chunk_values, ring_capacity, check
+    );
+
+    using Seconds = std::chrono::duration<double>;
+    auto seconds = [](pipeline::Duration duration) {
+      return std::chrono::duration_cast<Seconds>(duration).count();
+    };
+
+    const double total = seconds(result.total);
+    const double generate_stall = seconds(result.generate.output_stall);
+    const double format_stall =
+        seconds(result.format.input_stall + result.format.output_stall);
+    const double write_stall = seconds(result.write.input_stall);
+
+    const char* bottleneck = "generate";
+    if (format_stall < generate_stall && format_stall <= write_stall) {
+      bottleneck = "format";
+    }
+    else if (write_stall < generate_stall && write_stall < format_stall) {
+      bottleneck = "write";
+    }
+
+    std::cout << std::setw(40) << Algo::name();
+    std::cout << " [";
+    std::cout << "s:" << total << " ";
+    std::cout << "values/s:" << static_cast<double>(count) / total << " ";
+    std::cout << "MB/s:" << static_cast<double>(result.bytes) / 1e6 / total;
+    std::cout << " stall_s(generate:" << generate_stall;
+    std::cout << " format_in:" << seconds(result.format.input_stall);
+    std::cout << " format_out:" << seconds(result.format.output_stall);
+    std::cout << " write:" << write_stall << ")";
+    std::cout << " bottleneck:" << bottleneck;
+    std::cout << "]" << std::endl;
+
+#if !defined(NDEBUG)
+    std::ostringstream expected;
+    size_t next = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+      expected << input_.values()[next] << In::separator_t::str();
+      next = (next + 1) % input_.size();
+    }
+    if (copy != expected.str()) {
+      throw std::runtime_error(
+          std::string("Pipeline check failed: ") + Algo::name()
+      );
+    }
+#endif
+  }
+
+  // not instantiated for unsupported algorithms or not plain output
+  template <class Algo>
+  void run(const Algo&, std::false_type) {
+  }
+
+  const Options& options_;
+  const In& input_;
+  const int fd_;
+};
+
+// Values flow generate -> format -> write, output to file
+// INT_DEC_PIPELINE_OUTPUT (default: /dev/null)
+void run_pipeline(const Options& options) {
+  using In = PipelineTasks::In;
+
+  const char* path = std::getenv("INT_DEC_PIPELINE_OUTPUT");
+  if (path == nullptr) {
+    path = "/dev/null";
+  }
+
+  In input(1024 * 1024, 0, true, false);
+
+  std::cout << "Pipeline: generate " << get_name<PipelineTasks::Type>();
+  std::cout << " with ANY base-10 digits, format, write separated by ";
+  std::cout << In::separator_t::name() << " to " << path << std::endl;
+
+  const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("Can't open ") + path);
+  }
+
+  // stage threads on other CPUs
+  const benchmark::Unpinned unpinned;
+
+  PipelineTasks pipeline_tasks(options, input, fd);
+  try {
+    registry::for_each(registry::Formatters(), pipeline_tasks);
+  }
+  catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
 }
+#endif // !defined(_WIN32)
+
+template <class Separator>
+class ParseFunctor {
+ public:
+  ParseFunctor(
+      const Options& options,
+      size_t output_size,
+      int digit,
+      bool sign,
+      bool same_size,
+      const Distribution& distribution
+  ):
+      options_(options),
+      output_size_(output_size),
+      digit_(digit),
+      sign_(sign),
+      same_size_(same_size),
+      distribution_(distribution) {
+  }
+
+  template <class T>
+  void operator()(const T&) const {
+    if (!is_type_selected<T>(options_)) {
+      return;
+    }
+    run_parse_with_type<T, Separator>(
+        options_, output_size_, digit_, sign_, same_size_, distribution_
+    );
+  }
 
+ private:
+  const Options& options_;
+  const size_t output_size_;
+  const int digit_;
+  const bool sign_;
+  const bool same_size_;
+  const Distribution& distribution_;
+};
+
+template <class Operation>
+class InputFunctor {
+ public:
+  InputFunctor(
+      const Options& options,
+      size_t output_size,
+      int digit,
+      bool sign,
+      bool same_size,
+      const Distribution& distribution
+  ):
+      options_(options),
+      output_size_(output_size),
+      digit_(digit),
+      sign_(sign),
+      same_size_(same_size),
+      distribution_(distribution) {
+  }
+
+  template <class T>
+  void operator()(const T&) const {
+    if (!is_type_selected<T>(options_)) {
+      return;
+    }
+    run_input_with_type<T, Operation>(
+        options_, output_size_, digit_, sign_, same_size_, distribution_
+    );
+  }
+
+ private:
+  const Options& options_;
+  const size_t output_size_;
+  const int digit_;
+  const bool sign_;
+  const bool same_size_;
+  const Distribution& distribution_;
+};
+
+template <class Separator>
 class RunFunctor {
  public:
-  RunFunctor(size_t output_size, int digit, bool sign, bool same_size):
+  RunFunctor(
+      const Options& options,
+      size_t output_size,
+      int digit,
+      bool sign,
+      bool same_size,
+      const Distribution& distribution
+  ):
+      options_(options),
       output_size_(output_size),
       digit_(digit),
       sign_(sign),
-      same_size_(same_size) {
+      same_size_(same_size),
+      distribution_(distribution) {
   }
 
   template <class T>
   void operator()(const T&) const {
-    run_with_type<T>(output_size_, digit_, sign_, same_size_);
+    if (!is_type_selected<T>(options_)) {
+      return;
+    }
+    run_with_type<T, Separator>(
+        options_, output_size_, digit_, sign_, same_size_, distribution_
+    );
   }
 
  private:
+  const Options& options_;
   const size_t output_size_;
   const int digit_;
   const bool sign_;
   const bool same_size_;
+  const Distribution& distribution_;
 };
 
-int main() {
+void print_list(const char* title, const std::vector<std::string>& names) {
+  std::cout << title << ":";
+  for (auto& i: names) {
+    std::cout << " " << i;
+  }
+  std::cout << std::endl;
+}
+
+void print_usage(const char* program) {
+  std::cout << "usage: " << program << " [options]\n";
+  std::cout << "  --type=LIST       e.g. int,long_long,unsigned_int\n";
+  std::cout << "  --algo=LIST       formatters, parsers, counters, columns, ";
+  std::cout << "e.g. counting,parse_swar\n";
+  std::cout << "  --size=LIST       output buffer bytes, e.g. 30,4096\n";
+  std::cout << "  --digit=LIST      number of digits, 0 - any, e.g. 0,4\n";
+  std::cout << "  --sign=LIST       negative values: on,off\n";
+  std::cout << "  --same-size=LIST  digits of every value equal: on,off\n";
+  std::cout << "  --separator=LIST  formatting separator: none,comma\n";
+  std::cout << "  --distribution=LIST  uniform,log_uniform,zipf[:S],";
+  std::cout << "geometric[:P],monotone[:D],mixed_sign[:R],file:PATH\n";
+  std::cout << "                       (0 < P < 1, 0 <= R <= 1)\n";
+  std::cout << "  --operation=LIST  format,parse,count,column,parallel,\n";
+  std::cout << "                    coalesce,stream,pipeline\n";
+  std::cout << "  --list            print types and algorithms\n";
+  std::cout << "Option not set: all values" << std::endl;
+}
+
+int main(int argc, char** argv) {
   try {
-    using RunTypes = boost::fusion::vector<short, int, long, long long>;
+    const Options options(argc, argv);
 
-    std::vector<size_t> output_size_variants{30, 300, 4096};
-    std::vector<int> digit_variants{0, 1, 2, 4, 10};
-    std::vector<bool> sign_variants{true, false};
-    std::vector<bool> same_size_variants{true, false};
+    if (options.is_set("help")) {
+      print_usage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+
+    TypeNames type_names;
+    registry::for_each(registry::Types(), type_names);
+    std::vector<std::string> type_option_names;
+    for (auto& i: type_names.names) {
+      type_option_names.push_back(option_name(i.c_str()));
+    }
+    const std::vector<std::string> formatter_names =
+        algo_names<registry::Formatters>();
+    const std::vector<std::string> parser_names =
+        algo_names<registry::Parsers>();
+    const std::vector<std::string> counter_names =
+        algo_names<registry::Counters>();
+    const std::vector<std::string> column_names =
+        algo_names<registry::Columns>();
+
+    if (options.is_set("list")) {
+      print_list("Formatters", formatter_names);
+      print_list("Parsers", parser_names);
+      print_list("Counters", counter_names);
+      print_list("Columns", column_names);
+      print_list("Types", type_option_names);
+      return EXIT_SUCCESS;
+    }
+
+    std::vector<std::string> all_algo_names(formatter_names);
+    all_algo_names.insert(
+        all_algo_names.end(), parser_names.begin(), parser_names.end()
+    );
+    all_algo_names.insert(
+        all_algo_names.end(), counter_names.begin(), counter_names.end()
+    );
+    all_algo_names.insert(
+        all_algo_names.end(), column_names.begin(), column_names.end()
+    );
+    options.check("algo", all_algo_names);
+    std::vector<std::string> all_type_names(type_names.names);
+    all_type_names.insert(
+        all_type_names.end(), type_option_names.begin(), type_option_names.end()
+    );
+    options.check("type", all_type_names);
+    options.check("separator", {"none", "comma"});
+    options.check(
+        "operation",
+        {
+            "format",
+            "parse",
+            "count",
+            "column",
+            "parallel",
+            "coalesce",
+            "stream",
+            "pipeline"
+        }
+    );
+
+    // no migrations between samples
+    if (!benchmark::Affinity::pin()) {
+      std::cout << "Thread affinity not supported" << std::endl;
+    }
 
+    std::vector<size_t> output_size_variants{30, 300, 4096};
 #if defined(LONG_TEST) && defined(NDEBUG)
     output_size_variants.push_back(8 * 1024 * 1024);
 #endif
 
+    output_size_variants = options.numbers("size", output_size_variants);
+    const std::vector<int> digit_variants =
+        options.numbers("digit", std::vector<int>{0, 1, 2, 4, 10});
+    const std::vector<bool> sign_variants = options.flags("sign", {true, false});
+    const std::vector<bool> same_size_variants =
+        options.flags("same-size", {true, false});
+
+    std::vector<Distribution> distributions;
+    for (auto& i: options.values("distribution", Distribution::defaults())) {
+      distributions.emplace_back(i);
+    }
+
+    const bool run_format =
+        options.selected("operation", "format") &&
+        is_any_selected(options, formatter_names);
+    const bool run_parse =
+        options.selected("operation", "parse") &&
+        is_any_selected(options, parser_names);
+    const bool run_count =
+        options.selected("operation", "count") &&
+        is_any_selected(options, counter_names);
+    const bool run_column =
+        options.selected("operation", "column") &&
+        is_any_selected(options, column_names);
+
     bool run_any = false;
 
     for (auto output_size: output_size_variants) {
       for (auto digit: digit_variants) {
         for (auto sign: sign_variants) {
           for (auto same_size: same_size_variants) {
-            run_any = true;
+            for (auto& distribution: distributions) {
+              if (!distribution.is_applicable(digit, sign, same_size)) {
+                continue;
+              }
+              run_any = true;
+
+              if (run_format && options.selected("separator", "none")) {
+                const RunFunctor<separator::None> run_functor(
+                    options, output_size, digit, sign, same_size, distribution
+                );
+                registry::for_each(registry::Types(), run_functor);
+              }
 
-            const RunFunctor run_functor(output_size, digit, sign, same_size);
-            boost::fusion::for_each(RunTypes(), run_functor);
+              // cost of delimited output
+              if (run_format && options.selected("separator", "comma")) {
+                const RunFunctor<separator::Comma> run_functor_comma(
+                    options, output_size, digit, sign, same_size, distribution
+                );
+                registry::for_each(registry::Types(), run_functor_comma);
+              }
+
+              // parsing of delimited output
+              if (run_parse) {
+                const ParseFunctor<separator::Comma> parse_functor(
+                    options, output_size, digit, sign, same_size, distribution
+                );
+                registry::for_each(registry::Types(), parse_functor);
+              }
+
+              // first step of formatting alone
+              if (run_count) {
+                const InputFunctor<CountOperation> count_functor(
+                    options, output_size, digit, sign, same_size, distribution
+                );
+                registry::for_each(registry::Types(), count_functor);
+              }
+
+              // string column instead of text buffer
+              if (run_column) {
+                const InputFunctor<ColumnOperation> column_functor(
+                    options, output_size, digit, sign, same_size, distribution
+                );
+                registry::for_each(registry::Types(), column_functor);
+              }
+            }
           }
         }
       }
@@ -192,6 +1399,28 @@ int main() {
     if (!run_any) {
       throw std::runtime_error("Test list is empty");
     }
+
+    if (options.selected("operation", "parallel")) {
+      run_parallel_scaling();
+    }
+
+    if (options.selected("operation", "coalesce")) {
+      run_coalescing();
+    }
+
+#if !defined(_WIN32)
+    if (options.selected("operation", "stream")) {
+      run_stream();
+    }
+
+    if (
+        options.selected("operation", "pipeline") &&
+        is_any_selected(options, formatter_names)
+    ) {
+      run_pipeline(options);
+    }
+#endif
+
     return EXIT_SUCCESS;
   }
   catch (std::exception& exc) {
@@ -0,0 +1,44 @@
+#ifndef PARSERS_PARSE_SCALAR_HPP_
+#define PARSERS_PARSE_SCALAR_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <type_traits> // std::make_unsigned
+
+// One digit per iteration: value = value * 10 + digit.
+// Input is trusted (produced by formatters): no overflow checks,
+// parsing stops at the first non-digit char.
+namespace parse_scalar {
+
+// Append digits to `value`
+template <class Unsigned>
+inline void parse_digits(const char*& source, Unsigned& value) {
+  while (true) {
+    const unsigned digit = static_cast<unsigned char>(*source) - '0';
+    if (digit > 9) {
+      return;
+    }
+    value = static_cast<Unsigned>(value * 10 + digit);
+    ++source;
+  }
+}
+
+template <class Integer>
+inline Integer parse(const char*& source) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+
+  const bool negative = (*source == '-');
+  if (negative) {
+    ++source;
+  }
+
+  Unsigned value = 0;
+  parse_digits(source, value);
+
+  return static_cast<Integer>(negative ? 0 - value : value);
+}
+
+} // namespace parse_scalar
+
+#endif // PARSERS_PARSE_SCALAR_HPP_
@@ -0,0 +1,173 @@
+#ifndef PARSERS_PARSE_SIMD_HPP_
+#define PARSERS_PARSE_SIMD_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint64_t
+#include <type_traits> // std::make_unsigned
+
+#include "Int128.hpp"
+#include "parse_swar.hpp"
+#include "simd.hpp" // simd::enabled, ALGOS_SIMD_TARGET
+
+// Delimited input parsed with SSE4.1: 16 chars loaded at once,
+// digits found by compare + movemask, up to 16 digits converted by
+// multiply-add (`pmaddubsw`, `pmaddwd`). Used while at least 16 chars
+// available before `end`, `parse_swar` used for the rest and as
+// fallback if SSE4.1 is not supported (checked once per vector).
+namespace parse_simd {
+
+#if ALGOS_SIMD_X86
+
+inline uint64_t power10(size_t digits) {
+  static const uint64_t table[] = {
+      1ull,
+      10ull,
+      100ull,
+      1000ull,
+      10000ull,
+      100000ull,
+      1000000ull,
+      10000000ull,
+      100000000ull,
+      1000000000ull,
+      10000000000ull,
+      100000000000ull,
+      1000000000000ull,
+      10000000000000ull,
+      100000000000000ull,
+      1000000000000000ull,
+      10000000000000000ull
+  };
+  assert(digits <= 16);
+  return table[digits];
+}
+
+inline size_t trailing_zeros(unsigned value) {
+  assert(value != 0);
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, value);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctz(value));
+#endif
+}
+
+// Convert first `digits` chars (values 0..9) to number
+ALGOS_SIMD_TARGET
+inline uint64_t convert_digits(__m128i values, size_t digits) {
+  assert(digits > 0);
+  assert(digits <= 16);
+
+  // move digits to the end, leading positions zeroed
+  // (shuffle index with high bit set)
+  const __m128i index = _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(static_cast<int>(digits) - 16))
+  );
+  const __m128i aligned = _mm_shuffle_epi8(values, index);
+
+  // 16 x 1 digit -> 8 x 2 digits -> 4 x 4 digits -> 2 x 8 digits
+  const __m128i pairs = _mm_maddubs_epi16(
+      aligned,
+      _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1)
+  );
+  const __m128i quads = _mm_madd_epi16(
+      pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1)
+  );
+  const __m128i packed = _mm_packus_epi32(quads, quads);
+  const __m128i eights = _mm_madd_epi16(
+      packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1)
+  );
+
+  const uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(eights));
+  const uint64_t low = static_cast<uint32_t>(_mm_extract_epi32(eights, 1));
+  return high * 100000000ull + low;
+}
+
+// Append digits to `value`
+template <class Unsigned>
+ALGOS_SIMD_TARGET
+inline void parse_digits(const char*& source, const char* end, Unsigned& value) {
+  while (end - source >= 16) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    const __m128i values = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+
+    // digit if unsigned(char - '0') <= 9
+    const __m128i is_digit =
+        _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(is_digit));
+
+    // bit 16 is a stop bit: 16 digits
+    const size_t digits = trailing_zeros(~mask | 0x10000u);
+    if (digits != 0) {
+      value = static_cast<Unsigned>(
+          value * power10(digits) + convert_digits(values, digits)
+      );
+      source += digits;
+    }
+    if (digits != 16) {
+      return;
+    }
+  }
+
+  parse_swar::parse_digits(source, end, value);
+}
+
+template <class Integer>
+ALGOS_SIMD_TARGET
+inline Integer parse_value(const char*& source, const char* end) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+  using Wide = typename WideUnsigned<Unsigned>::type;
+
+  const bool negative = (*source == '-');
+  if (negative) {
+    ++source;
+  }
+
+  Wide value = 0;
+  parse_digits(source, end, value);
+
+  const Unsigned result = static_cast<Unsigned>(value);
+  return static_cast<Integer>(negative ? 0 - result : result);
+}
+
+// Whole loop compiled for SSE4.1: `parse_value` inlined
+template <class Separator, class Vector>
+ALGOS_SIMD_TARGET
+inline void parse_vector(const char* source, const char* end, Vector& out) {
+  using Integer = typename Vector::value_type;
+  for (auto& i: out) {
+    i = parse_value<Integer>(source, end);
+    source += Separator::size;
+  }
+}
+
+#endif // ALGOS_SIMD_X86
+
+// Parse `out.size()` values from [source, end),
+// values separated by `Separator`
+template <class Separator, class Vector>
+inline void parse(const char* source, const char* end, Vector& out) {
+  using Integer = typename Vector::value_type;
+
+#if ALGOS_SIMD_X86
+  if (simd::enabled()) {
+    parse_vector<Separator>(source, end, out);
+    return;
+  }
+#endif
+
+  for (auto& i: out) {
+    i = parse_swar::parse<Integer>(source, end);
+    source += Separator::size;
+  }
+}
+
+} // namespace parse_simd
+
+#endif // PARSERS_PARSE_SIMD_HPP_
@@ -0,0 +1,39 @@
+#ifndef PARSERS_PARSE_STRTOLL_HPP_
+#define PARSERS_PARSE_STRTOLL_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cstdlib> // std::strtoll
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::integral_constant
+
+// Reference parser: C library `strtoll`/`strtoull`
+namespace parse_strtoll {
+
+template <class Integer>
+inline Integer parse(const char*& source, std::true_type /* signed */) {
+  char* end;
+  const long long value = std::strtoll(source, &end, 10);
+  source = end;
+  return static_cast<Integer>(value);
+}
+
+template <class Integer>
+inline Integer parse(const char*& source, std::false_type /* signed */) {
+  char* end;
+  const unsigned long long value = std::strtoull(source, &end, 10);
+  source = end;
+  return static_cast<Integer>(value);
+}
+
+template <class Integer>
+inline Integer parse(const char*& source) {
+  using IsSigned =
+      std::integral_constant<bool, std::numeric_limits<Integer>::is_signed>;
+  return parse<Integer>(source, IsSigned());
+}
+
+} // namespace parse_strtoll
+
+#endif // PARSERS_PARSE_STRTOLL_HPP_
@@ -0,0 +1,126 @@
+#ifndef PARSERS_PARSE_SWAR_HPP_
+#define PARSERS_PARSE_SWAR_HPP_
+
+// Copyright (c) 2014, Ruslan Baratov
+// All rights reserved.
+
+#include <cassert> // assert
+#include <cstdint> // uint64_t
+#include <cstring> // std::memcpy
+#include <type_traits> // std::make_unsigned
+
+#if defined(_MSC_VER)
+# include <intrin.h> // _BitScanForward
+#endif
+
+#include "Int128.hpp"
+#include "parse_scalar.hpp"
+
+// SIMD within a register: 8 chars loaded to uint64_t, checked and
+// converted to number by 3 multiplications (no loop over digits).
+// Used while at least 8 chars available before `end`, the rest
+// is parsed by `parse_scalar`.
+namespace parse_swar {
+
+const uint64_t ONES = 0x0101010101010101ull;
+
+// First char in the lowest byte
+inline uint64_t load_8(const char* source) {
+  uint64_t result;
+  std::memcpy(&result, source, sizeof(result)); // one unaligned load
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  result = __builtin_bswap64(result);
+#endif
+  return result;
+}
+
+// Non-zero byte for every char which is not a digit ('0'..'9')
+inline uint64_t non_digits(uint64_t chars) {
+  // carry from `+ 6` can only affect bytes after the non-digit one
+  const uint64_t high = chars & (0xF0 * ONES);
+  const uint64_t high_6 = (chars + 0x06 * ONES) & (0xF0 * ONES);
+  return (high ^ (0x30 * ONES)) | (high_6 ^ (0x30 * ONES));
+}
+
+inline size_t trailing_zeros(uint64_t value) {
+  assert(value != 0);
+#if defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanForward(&index, static_cast<unsigned long>(value))) {
+    return index;
+  }
+  _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+  return 32 + index;
+#else
+  return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+}
+
+// 8 digits (first char in the lowest byte) to number.
+// Only low nibbles used, i.e. zero bytes are leading zeros.
+inline uint32_t convert_8_digits(uint64_t chars) {
+  uint64_t value = chars & (0x0F * ONES);
+  value = (value * 10 + (value >> 8)) & 0x00FF00FF00FF00FFull; // pairs
+  value = (value * 100 + (value >> 16)) & 0x0000FFFF0000FFFFull; // quads
+  return static_cast<uint32_t>((value * 10000 + (value >> 32)) & 0xFFFFFFFF);
+}
+
+inline uint32_t power10(size_t digits) {
+  static const uint32_t table[] = {
+      1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+  };
+  assert(digits <= 8);
+  return table[digits];
+}
+
+// Append digits to `value`
+template <class Unsigned>
+inline void parse_digits(const char*& source, const char* end, Unsigned& value) {
+  while (end - source >= 8) {
+    const uint64_t chars = load_8(source);
+    const uint64_t mask = non_digits(chars);
+
+    if (mask == 0) {
+      value = static_cast<Unsigned>(value * power10(8) + convert_8_digits(chars));
+      source += 8;
+      continue;
+    }
+
+    // 0..7 digits followed by separator
+    const size_t digits = trailing_zeros(mask) / 8;
+    if (digits != 0) {
+      // move digits to the high bytes, low bytes become leading zeros
+      const uint64_t aligned = chars << (8 * (8 - digits));
+      value = static_cast<Unsigned>(
+          value * power10(digits) + convert_8_digits(aligned)
+      );
+      source += digits;
+    }
+    return;
+  }
+
+  parse_scalar::parse_digits(source, value);
+}
+
+template <class Integer>
+inline Integer parse(const char*& source, const char* end) {
+  using Unsigned = typename std::make_unsigned<Integer>::type;
+
+  // 8 digits don't fit 16-bit type
+  using Wide = typename WideUnsigned<Unsigned>::type;
+
+  const bool negative = (*source == '-');
+  if (negative) {
+    ++source;
+  }
+
+  Wide value = 0;
+  parse_digits(source, end, value);
+
+  const Unsigned result = static_cast<Unsigned>(value);
+  return static_cast<Integer>(negative ? 0 - result : result);
+}
+
+} // namespace parse_swar
+
+#endif // PARSERS_PARSE_SWAR_HPP_